@@ -1,13 +1,17 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <optional>
-#include <random>
+#include <span>
 #include <vector>
 
-#include "../Objects/Card.hpp"
+#include "../Objects/CardModel.hpp"
+#include "Rng.hpp"
+#include "Zobrist.hpp"
 
 /**
  * 牌堆内部使用的轻量牌数据。
@@ -21,6 +25,16 @@ struct CardData {
     int baseChips;
 };
 
+/**
+ * 剩余牌按点数与花色的张数。
+ *
+ * 点数下标为 rank - 2，花色下标为 Suit 的枚举值（含 Suit::None）。
+ */
+struct DeckCounts {
+    std::array<std::uint8_t, 13> ranks{};
+    std::array<std::uint8_t, 5> suits{};
+};
+
 class Deck {
 public:
     using RankChipProvider = std::function<int(Rank)>;
@@ -45,6 +59,8 @@ public:
      */
     void initStandardDeck() {
         m_cards.clear();
+        m_zobrist = 0;
+        m_counts = DeckCounts{};
         for (int s = 0; s < 4; ++s) {
             for (int r = 2; r <= 14; ++r) {
                 CardData data;
@@ -52,6 +68,7 @@ public:
                 data.rank = (Rank)r;
                 data.baseChips = getBaseChips(data.rank);
                 m_cards.push_back(data);
+                track(data, 1);
             }
         }
     }
@@ -59,25 +76,15 @@ public:
     /**
      * 原地洗牌。
      *
-     * 提供 `pickIndex` 时走可控 Fisher-Yates，用于稳定回放或测试。
-     * 不提供时走随机设备驱动的常规洗牌。
+     * 由调用方提供随机流，洗牌结果只取决于流的种子与位置，便于回放与种子搜索。
      *
-     * @param pickIndex 可选索引生成函数
+     * @param rng 随机流
      */
-    void shuffle(const std::function<std::size_t(std::size_t)>& pickIndex = {}) {
-        if (m_cards.size() < 2) return;
-
-        if (pickIndex) {
-            for (std::size_t i = m_cards.size() - 1; i > 0; --i) {
-                const std::size_t j = pickIndex(i + 1) % (i + 1);
-                std::swap(m_cards[i], m_cards[j]);
-            }
-            return;
+    void shuffle(RngStream& rng) {
+        for (std::size_t i = m_cards.size(); i > 1; --i) {
+            const std::size_t j = rng.uniform(i);
+            std::swap(m_cards[i - 1], m_cards[j]);
         }
-
-        static std::random_device rd;
-        static std::mt19937 g(rd());
-        std::shuffle(m_cards.begin(), m_cards.end(), g);
     }
 
     /**
@@ -93,6 +100,7 @@ public:
         }
         CardData top = m_cards.back();
         m_cards.pop_back();
+        track(top, -1);
         return top;
     }
 
@@ -105,6 +113,65 @@ public:
         return static_cast<int>(m_cards.size());
     }
 
+    /**
+     * 获取剩余牌，末尾为下一张抽到的牌。
+     *
+     * @return 只读牌序列
+     */
+    std::span<const CardData> cards() const { return m_cards; }
+
+    /**
+     * 获取剩余牌的多重集 Zobrist 键。
+     *
+     * 抽牌与加牌时增量维护；洗牌不改变牌的集合，因此键不变。
+     *
+     * @return 成员键之和
+     */
+    std::uint64_t zobrist() const { return m_zobrist; }
+
+    /**
+     * 获取剩余牌按点数与花色的张数。
+     *
+     * 与 Zobrist 键一样随抽牌与加牌增量维护，供抽牌概率等查询直接使用。
+     *
+     * @return 张数统计
+     */
+    const DeckCounts& counts() const { return m_counts; }
+
+    /**
+     * 恢复快照中的牌序。
+     *
+     * 不经过筹码提供器，快照中已记录筹码值。
+     * 写入后立即重算 Zobrist 键与张数统计，const 查询不修改任何状态，可跨线程并发读取。
+     *
+     * @param count 牌数
+     * @param fill 写满给定 std::span<CardData> 的回调
+     */
+    template <typename Fill>
+    void restore(std::size_t count, Fill&& fill) {
+        m_cards.resize(count);
+        fill(std::span<CardData>(m_cards));
+        m_zobrist = 0;
+        m_counts = DeckCounts{};
+        for (const CardData& card : m_cards) track(card, 1);
+    }
+
+    /**
+     * 恢复牌序，派生的 Zobrist 键与张数统计由调用方给出，不再逐张重算。
+     *
+     * @param count 牌数
+     * @param fill 写满给定 std::span<CardData> 的回调
+     * @param zobrist 写入牌的多重集键
+     * @param counts 写入牌的张数统计
+     */
+    template <typename Fill>
+    void restore(std::size_t count, Fill&& fill, std::uint64_t zobrist, const DeckCounts& counts) {
+        m_cards.resize(count);
+        fill(std::span<CardData>(m_cards));
+        m_zobrist = zobrist;
+        m_counts = counts;
+    }
+
     /**
      * 追加一张牌到牌堆。
      *
@@ -119,6 +186,7 @@ public:
         data.rank = r;
         data.baseChips = getBaseChips(r);
         m_cards.push_back(data);
+        track(data, 1);
     }
 
 private:
@@ -129,6 +197,19 @@ private:
         return 0;
     }
 
+    void track(const CardData& card, int delta) {
+        const std::uint64_t key = Zobrist::Card(card.suit, card.rank);
+        m_zobrist += delta > 0 ? key : 0 - key;
+        const auto rank = static_cast<std::size_t>(card.rank) - static_cast<std::size_t>(Rank::Two);
+        const auto suit = static_cast<std::size_t>(card.suit);
+        if (rank < m_counts.ranks.size()) m_counts.ranks[rank] = static_cast<std::uint8_t>(m_counts.ranks[rank] + delta);
+        if (suit < m_counts.suits.size()) m_counts.suits[suit] = static_cast<std::uint8_t>(m_counts.suits[suit] + delta);
+    }
+
     std::vector<CardData> m_cards;
     RankChipProvider m_rankChipProvider;
+
+    // 由 m_cards 派生的键与统计，每次修改牌序时同步更新。
+    std::uint64_t m_zobrist = 0;
+    DeckCounts m_counts;
 };
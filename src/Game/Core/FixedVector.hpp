@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+/**
+ * 定容内联数组。
+ *
+ * 元素直接存放在对象内部，容量在编译期确定，
+ * 用于替代结算热路径上元素数有明确上限的 std::vector，避免堆分配。
+ * 超出容量的写入会触发断言；发布构建中忽略该元素并由 push_back 返回 false，
+ * 不能容忍丢失元素的调用方须检查返回值。
+ */
+template <typename T, std::size_t Capacity>
+class FixedVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    FixedVector() = default;
+
+    /**
+     * 追加元素。
+     *
+     * @param value 元素
+     * @return 容量已满、元素被丢弃时返回 false
+     */
+    bool push_back(const T& value) {
+        assert(m_size < Capacity && "FixedVector capacity exceeded");
+        if (m_size >= Capacity) return false;
+        m_items[m_size++] = value;
+        return true;
+    }
+
+    /**
+     * 清空元素，不释放存储。
+     */
+    void clear() { m_size = 0; }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    T* data() { return m_items.data(); }
+    const T* data() const { return m_items.data(); }
+
+    T& operator[](std::size_t index) { return m_items[index]; }
+    const T& operator[](std::size_t index) const { return m_items[index]; }
+
+    iterator begin() { return m_items.data(); }
+    iterator end() { return m_items.data() + m_size; }
+    const_iterator begin() const { return m_items.data(); }
+    const_iterator end() const { return m_items.data() + m_size; }
+
+private:
+    std::array<T, Capacity> m_items{};
+    std::size_t m_size = 0;
+};
@@ -2,13 +2,42 @@
 #include "../States/RunState.hpp"
 #include "../Systems/GameDatabase.hpp"
 #include "../Systems/ResourceManager.hpp"
-#include <ctime>
-#include <cstdlib>
 #include <iostream>
+#include <random>
 #include <algorithm>
 
-Game::Game() {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+namespace {
+
+// 1 倍速下相邻两条回放操作的间隔秒数，留出发牌与飘字动画时间。
+constexpr float REPLAY_ACTION_INTERVAL = 0.6f;
+
+} // namespace
+
+Game::Game(const GameOptions& options) {
+    std::uint64_t seed = 0;
+    if (!options.replayPath.empty()) {
+        std::string error;
+        if (ReplayFormat::Load(options.replayPath, m_replay, error)) {
+            m_replaying = true;
+            m_replaySpeed = options.replaySpeed > 0.0f ? options.replaySpeed : 1.0f;
+            seed = m_replay.seed;
+            std::cout << "[Info] Replaying " << m_replay.actions.size() << " actions from "
+                      << options.replayPath << " at " << m_replaySpeed << "x" << std::endl;
+        } else {
+            std::cerr << "[Error] Replay load failed: " << error << std::endl;
+        }
+    }
+
+    if (!m_replaying) {
+        // 整局随机只由这一个种子决定，打印出来便于复现同一局。
+        std::random_device rd;
+        seed = (static_cast<std::uint64_t>(rd()) << 32) | rd();
+        if (!options.recordPath.empty() && !m_recorder.open(options.recordPath, seed)) {
+            std::cerr << "[Warning] Failed to open replay output " << options.recordPath << std::endl;
+        }
+    }
+    m_ctx.rng.reseed(seed);
+    std::cout << "[Info] Run seed: " << seed << std::endl;
 
     initWindow();
     m_bootstrapReady = initResources();
@@ -23,6 +52,14 @@ void Game::changeState(std::unique_ptr<IGameState> newState) {
     m_stateMachine.changeState(*this, std::move(newState));
 }
 
+bool Game::dispatchAction(const ReplayAction& action) {
+    if (m_replaying) return false;
+    auto* state = m_stateMachine.currentState();
+    if (!state || !state->applyAction(*this, action)) return false;
+    m_recorder.record(action);
+    return true;
+}
+
 void Game::initWindow() {
     m_window.create(sf::VideoMode(1280, 720), "Balatro C++ State Pattern");
     m_window.setFramerateLimit(60);
@@ -115,7 +152,9 @@ void Game::run() {
     while (m_window.isOpen()) {
         float dt = clock.restart().asSeconds();
         if (dt > 0.1f) dt = 0.1f;
+        if (m_replaying) dt *= m_replaySpeed;
         processEvents();
+        advanceReplay(dt);
         update(dt);
         render();
     }
@@ -123,12 +162,35 @@ void Game::run() {
 
 void Game::processEvents() {
     m_inputRouter.process(m_window, [this](const sf::Event& event) {
+        if (m_replaying) return;
         if (auto* state = m_stateMachine.currentState()) {
             state->handleEvent(*this, event);
         }
     });
 }
 
+void Game::advanceReplay(float dt) {
+    if (!m_replaying) return;
+
+    m_replayTimer += dt;
+    while (m_replayTimer >= REPLAY_ACTION_INTERVAL && m_replayCursor < m_replay.actions.size()) {
+        m_replayTimer -= REPLAY_ACTION_INTERVAL;
+        auto* state = m_stateMachine.currentState();
+        const ReplayAction& action = m_replay.actions[m_replayCursor];
+        if (!state || !state->applyAction(*this, action)) {
+            // 录像与当前规则不一致时停在出错处，方便对照现场排查。
+            std::cerr << "[Error] Replay diverged at action " << m_replayCursor << std::endl;
+            m_replayCursor = m_replay.actions.size();
+            break;
+        }
+        ++m_replayCursor;
+    }
+    if (m_replayCursor >= m_replay.actions.size()) {
+        std::cout << "[Info] Replay finished." << std::endl;
+        m_replaying = false;
+    }
+}
+
 void Game::update(float dt) {
     m_renderPipeline.update(dt);
 
@@ -18,13 +18,25 @@
 #include "../Objects/CardArea.hpp"
 #include "../Data/CRTParams.hpp"
 #include "../Systems/StartupPolicy.hpp"
+#include "../Systems/Replay.hpp"
+
+/**
+ * 启动参数。
+ */
+struct GameOptions {
+    std::string recordPath = "last_run.brep";  // 实时游玩时的录像输出
+    std::string replayPath;                    // 非空时进入渲染回放模式
+    float replaySpeed = 1.0f;                  // 回放倍速，同时作用于动画与操作间隔
+};
 
 class Game {
 public:
     /**
      * 构造游戏对象并完成启动初始化。
+     *
+     * @param options 启动参数
      */
-    Game();
+    explicit Game(const GameOptions& options = {});
     ~Game() = default;
 
     /**
@@ -42,6 +54,16 @@ public:
      */
     void changeState(std::unique_ptr<IGameState> newState);
 
+    /**
+     * 执行并记录一条玩家操作。
+     *
+     * 回放期间拒绝来自输入的操作，避免玩家输入与录像交错。
+     *
+     * @param action 玩家操作
+     * @return 是否执行成功
+     */
+    bool dispatchAction(const ReplayAction& action);
+
     /**
      * 获取运行时上下文。
      *
@@ -85,6 +107,7 @@ private:
     void initScene();
 
     void processEvents();
+    void advanceReplay(float dt);
     void update(float dt);
     void render();
 
@@ -106,4 +129,11 @@ private:
 
     StateMachine m_stateMachine;
     bool m_bootstrapReady = true;
+
+    ReplayRecorder m_recorder;
+    Replay m_replay;
+    std::size_t m_replayCursor = 0;
+    float m_replayTimer = 0.0f;
+    float m_replaySpeed = 1.0f;
+    bool m_replaying = false;
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include <cassert>
 #include "Deck.hpp"
+#include "Rng.hpp"
 
 class CardArea;
 class GameDatabase;
@@ -18,6 +19,7 @@ struct GameContext {
     GameState state = GameState::Menu;
     
     Deck deck;
+    RngService rng;
     GameDatabase* database = nullptr;
     ResourceManager* resources = nullptr;
 
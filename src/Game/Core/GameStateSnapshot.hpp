@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#include "FixedVector.hpp"
+#include "GameContext.hpp"
+#include "Zobrist.hpp"
+#include "../Systems/CardSnapshot.hpp"
+
+/**
+ * 四字节压缩牌。
+ *
+ * 高 4 位为花色、低 4 位为点数，另存 16 位有符号的筹码，
+ * 容纳增强、减益后的筹码值，足以还原牌堆与手牌。
+ */
+struct PackedCard {
+    std::uint8_t code = 0;
+    std::int16_t chips = 0;
+
+    /**
+     * 打包单张牌，超出 16 位范围的筹码会触发断言，发布构建中截断到边界。
+     */
+    static PackedCard Pack(Suit suit, Rank rank, int chips) {
+        using Limits = std::numeric_limits<std::int16_t>;
+        assert(chips >= Limits::min() && chips <= Limits::max() && "card chips out of PackedCard range");
+        return PackedCard{
+            static_cast<std::uint8_t>((static_cast<int>(suit) << 4) | static_cast<int>(rank)),
+            static_cast<std::int16_t>(std::clamp<int>(chips, Limits::min(), Limits::max())),
+        };
+    }
+
+    Suit suit() const { return static_cast<Suit>(code >> 4); }
+    Rank rank() const { return static_cast<Rank>(code & 0x0F); }
+};
+
+/**
+ * 整局状态的平坦快照。
+ *
+ * 只含定长数组与整数，可按字节复制，树搜索每次克隆局面只是一次 memcpy。
+ * Joker 与商品以排序后 Joker ID 池的下标表示，效果对象由恢复方按需重建。
+ */
+struct GameStateSnapshot {
+    static constexpr std::size_t MAX_DECK = 64;
+    static constexpr std::size_t MAX_HAND = 16;   // 与 16 位选牌掩码一致
+    static constexpr std::size_t MAX_JOKERS = 8;
+    static constexpr std::size_t MAX_OFFERS = 8;
+
+    struct Offer {
+        std::uint8_t joker = 0;
+        std::int16_t cost = 0;
+    };
+
+    GameState state = GameState::Run;
+    std::int8_t handsLeft = 0;
+    std::int8_t discardsLeft = 0;
+    std::int32_t money = 0;
+    std::int64_t currentScore = 0;
+    std::int64_t targetScore = 0;
+    std::int32_t roundsCleared = 0;
+    std::array<std::int32_t, 13> handTypeCounts{};
+
+    FixedVector<PackedCard, MAX_DECK> deck;
+    FixedVector<PackedCard, MAX_HAND> hand;
+    FixedVector<std::uint8_t, MAX_JOKERS> jokers;
+    FixedVector<Offer, MAX_OFFERS> offers;
+
+    RngService rng;
+
+    /**
+     * 从上下文拷入计数器、牌堆与随机流。
+     *
+     * 手牌、Joker 与商品不在 GameContext 中，由持有方另行填写。
+     *
+     * @param ctx 上下文
+     * @return 牌堆超过 MAX_DECK 时返回 false，此时快照不完整，不能用于恢复
+     */
+    [[nodiscard]] bool captureContext(const GameContext& ctx) {
+        state = ctx.state;
+        handsLeft = static_cast<std::int8_t>(ctx.handsLeft);
+        discardsLeft = static_cast<std::int8_t>(ctx.discardsLeft);
+        money = ctx.money;
+        currentScore = ctx.currentScore;
+        targetScore = ctx.targetScore;
+        rng = ctx.rng;
+
+        deck.clear();
+        for (const CardData& card : ctx.deck.cards()) {
+            if (!deck.push_back(PackedCard::Pack(card.suit, card.rank, card.baseChips))) return false;
+        }
+        return true;
+    }
+
+    /**
+     * 把计数器与随机流写回上下文，牌堆保持不变。
+     *
+     * 供牌堆另有来源（例如搜索中重新洗过的 PackedDeck）的恢复路径使用。
+     *
+     * @param ctx 上下文
+     */
+    void restoreCounters(GameContext& ctx) const {
+        ctx.state = state;
+        ctx.handsLeft = handsLeft;
+        ctx.discardsLeft = discardsLeft;
+        ctx.money = money;
+        ctx.currentScore = currentScore;
+        ctx.targetScore = targetScore;
+        ctx.rng = rng;
+    }
+
+    /**
+     * 把计数器、牌堆与随机流写回上下文。
+     *
+     * @param ctx 上下文
+     */
+    void restoreContext(GameContext& ctx) const {
+        restoreCounters(ctx);
+        ctx.deck.restore(deck.size(), [this](std::span<CardData> cards) {
+            for (std::size_t i = 0; i < cards.size(); ++i) {
+                cards[i] = CardData{deck[i].suit(), deck[i].rank(), deck[i].chips};
+            }
+        });
+    }
+
+    /**
+     * 计算局面的 Zobrist 键。
+     *
+     * 覆盖手牌与剩余牌的多重集、Joker 编队、商品与计数器，随机流与统计不参与。
+     * 与 RunSimulator::zobrist 的增量键一致，搜索可用任一方查表。
+     *
+     * @return 局面键
+     */
+    std::uint64_t zobrist() const {
+        std::uint64_t deckKey = 0;
+        for (const PackedCard card : deck) deckKey += Zobrist::Card(card.suit(), card.rank());
+        std::uint64_t handKey = 0;
+        for (const PackedCard card : hand) handKey += Zobrist::Card(card.suit(), card.rank());
+        std::uint64_t jokerKey = 0;
+        for (std::size_t i = 0; i < jokers.size(); ++i) jokerKey += Zobrist::Joker(jokers[i], i);
+        std::uint64_t offerKey = 0;
+        for (std::size_t i = 0; i < offers.size(); ++i) offerKey += Zobrist::Offer(offers[i].joker, i, offers[i].cost);
+
+        return ComposeZobrist(deckKey, handKey, jokerKey, offerKey) ^
+               CounterKey(state, handsLeft, discardsLeft, money, currentScore, targetScore, roundsCleared);
+    }
+
+    /**
+     * 合成四个区域的多重集键。
+     */
+    static std::uint64_t ComposeZobrist(std::uint64_t deckKey, std::uint64_t handKey,
+                                        std::uint64_t jokerKey, std::uint64_t offerKey) {
+        return Zobrist::InZone(Zobrist::Zone::Deck, deckKey) ^
+               Zobrist::InZone(Zobrist::Zone::Hand, handKey) ^
+               Zobrist::InZone(Zobrist::Zone::Jokers, jokerKey) ^
+               Zobrist::InZone(Zobrist::Zone::Offers, offerKey);
+    }
+
+    /**
+     * 合成计数器键，计数器变化时只需重算这一项。
+     */
+    static std::uint64_t CounterKey(GameState state, int handsLeft, int discardsLeft, int money,
+                                    long long currentScore, long long targetScore, int roundsCleared) {
+        using Zobrist::Field;
+        return Zobrist::Counter(Field::State, static_cast<int>(state)) ^
+               Zobrist::Counter(Field::HandsLeft, handsLeft) ^
+               Zobrist::Counter(Field::DiscardsLeft, discardsLeft) ^
+               Zobrist::Counter(Field::Money, money) ^
+               Zobrist::Counter(Field::CurrentScore, currentScore) ^
+               Zobrist::Counter(Field::TargetScore, targetScore) ^
+               Zobrist::Counter(Field::RoundsCleared, roundsCleared);
+    }
+
+    static PackedCard Pack(const CardSnapshot& card) {
+        return PackedCard::Pack(card.suit, card.rank, card.chips);
+    }
+
+    static CardSnapshot Unpack(PackedCard card) {
+        return CardSnapshot{.suit = card.suit(), .rank = card.rank(), .chips = card.chips};
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<GameStateSnapshot>, "snapshots must clone with memcpy");
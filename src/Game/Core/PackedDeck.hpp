@@ -0,0 +1,252 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "Deck.hpp"
+
+/**
+ * 紧凑牌堆：64 位在堆掩码 + 单字节编码的抽牌顺序。
+ *
+ * 每张牌编码为 suit * 13 + rank - 2，只能容纳一副标准牌且不允许重复，
+ * 筹码值不逐张存储，而是在开局时从点数筹码提供器拍下一张 15 项的表。
+ * 整个对象约一百字节且可平凡复制，重置即拷贝一份标准牌模板，
+ * 适合模拟与搜索中大量重建、洗牌、克隆牌堆的场景。
+ *
+ * 抽牌约定与 Deck 相同：末尾为下一张，同一随机流洗牌后抽出的牌序完全一致。
+ */
+class PackedDeck {
+public:
+    static constexpr std::size_t CAPACITY = 52;
+    static constexpr int RANKS_PER_SUIT = 13;
+
+    /**
+     * 按 Rank 枚举值索引的筹码表，下标 0、1 不使用。
+     */
+    using ChipTable = std::array<std::int16_t, 15>;
+
+    /**
+     * 从点数筹码提供器拍下筹码表。
+     *
+     * @param provider 点数筹码查询函数，为空时全部为 0
+     * @return 筹码表
+     */
+    static ChipTable SnapshotChips(const Deck::RankChipProvider& provider) {
+        ChipTable chips{};
+        if (!provider) return chips;
+        for (int r = static_cast<int>(Rank::Two); r <= static_cast<int>(Rank::Ace); ++r) {
+            chips[static_cast<std::size_t>(r)] = static_cast<std::int16_t>(provider(static_cast<Rank>(r)));
+        }
+        return chips;
+    }
+
+    /**
+     * 牌的单字节编码。
+     *
+     * @param suit 花色，不能为 Suit::None
+     * @param rank 点数
+     * @return 0..51
+     */
+    static constexpr std::uint8_t IndexOf(Suit suit, Rank rank) {
+        return static_cast<std::uint8_t>(static_cast<int>(suit) * RANKS_PER_SUIT +
+                                         static_cast<int>(rank) - static_cast<int>(Rank::Two));
+    }
+
+    PackedDeck() = default;
+
+    explicit PackedDeck(const ChipTable& chips) : m_chips(chips) {}
+
+    /**
+     * 初始化标准 52 张牌，顺序与 Deck::initStandardDeck 一致。
+     */
+    void initStandardDeck() {
+        m_order = STANDARD_ORDER;
+        m_present = FULL_MASK;
+        m_size = static_cast<std::uint8_t>(CAPACITY);
+        m_zobrist = STANDARD_ZOBRIST;
+    }
+
+    /**
+     * 以给定顺序初始化完整的 52 张牌，例如 BatchShuffle 生成的排列。
+     *
+     * @param order 牌编码的排列，末尾为下一张
+     */
+    void initStandardDeck(const std::array<std::uint8_t, CAPACITY>& order) {
+        m_order = order;
+        m_present = FULL_MASK;
+        m_size = static_cast<std::uint8_t>(CAPACITY);
+        m_zobrist = STANDARD_ZOBRIST;
+    }
+
+    /**
+     * 原地洗牌。
+     *
+     * 与 Deck::shuffle 消耗相同的随机数；只关心接下来 draws 张时可提前停止，
+     * 此时末尾 draws 张与完整洗牌的结果相同，但随机流前进得更少。
+     *
+     * @param rng 随机流
+     * @param draws 需要确定的末尾张数
+     */
+    void shuffle(RngStream& rng, std::size_t draws = CAPACITY) {
+        const std::size_t stop = draws >= m_size ? 1 : m_size - draws;
+        for (std::size_t i = m_size; i > stop; --i) {
+            const std::size_t j = rng.uniform(i);
+            std::swap(m_order[i - 1], m_order[j]);
+        }
+    }
+
+    /**
+     * 抽取一张牌。
+     *
+     * @return 抽到的牌；为空表示牌堆耗尽
+     */
+    std::optional<CardData> draw() {
+        if (m_size == 0) return std::nullopt;
+        const std::uint8_t index = m_order[--m_size];
+        m_present &= ~(1ULL << index);
+        const CardData card = cardOf(index);
+        m_zobrist -= Zobrist::Card(card.suit, card.rank);
+        return card;
+    }
+
+    /**
+     * 获取剩余牌数。
+     *
+     * @return 当前牌堆剩余张数
+     */
+    int getRemainingCount() const { return m_size; }
+
+    /**
+     * 获取剩余牌的编码，末尾为下一张抽到的牌。
+     *
+     * @return 只读编码序列
+     */
+    std::span<const std::uint8_t> order() const { return {m_order.data(), m_size}; }
+
+    /**
+     * 获取在堆掩码，第 IndexOf(suit, rank) 位表示该牌仍在牌堆中。
+     *
+     * @return 掩码
+     */
+    std::uint64_t presence() const { return m_present; }
+
+    bool contains(Suit suit, Rank rank) const {
+        return suit != Suit::None && ((m_present >> IndexOf(suit, rank)) & 1) != 0;
+    }
+
+    /**
+     * 获取剩余牌的多重集 Zobrist 键，与同内容 Deck 的键相同。
+     *
+     * @return 成员键之和
+     */
+    std::uint64_t zobrist() const { return m_zobrist; }
+
+    /**
+     * 按在堆掩码统计剩余牌的点数与花色张数。
+     *
+     * @return 张数统计
+     */
+    DeckCounts counts() const {
+        DeckCounts counts;
+        constexpr std::uint64_t SUIT_BITS = (1ULL << RANKS_PER_SUIT) - 1;
+        // 同一点数在四个花色中的位相隔 13 位。
+        constexpr std::uint64_t RANK_BITS = 1ULL | 1ULL << 13 | 1ULL << 26 | 1ULL << 39;
+        for (std::size_t s = 0; s < 4; ++s) {
+            counts.suits[s] = static_cast<std::uint8_t>(std::popcount((m_present >> (s * RANKS_PER_SUIT)) & SUIT_BITS));
+        }
+        for (std::size_t r = 0; r < counts.ranks.size(); ++r) {
+            counts.ranks[r] = static_cast<std::uint8_t>(std::popcount(m_present & (RANK_BITS << r)));
+        }
+        return counts;
+    }
+
+    /**
+     * 追加一张牌到牌堆末尾。
+     *
+     * @param suit 花色
+     * @param rank 点数
+     * @return 牌已在堆中或无法编码时返回 false
+     */
+    bool addCard(Suit suit, Rank rank) {
+        if (suit == Suit::None || contains(suit, rank)) return false;
+        const std::uint8_t index = IndexOf(suit, rank);
+        m_order[m_size++] = index;
+        m_present |= 1ULL << index;
+        m_zobrist += Zobrist::Card(suit, rank);
+        return true;
+    }
+
+    /**
+     * 按牌序载入，筹码值以筹码表为准。
+     *
+     * @param cards 牌序列，末尾为下一张
+     * @return 含重复牌或 Suit::None 时返回 false，牌堆被清空
+     */
+    bool assign(std::span<const CardData> cards) {
+        m_present = 0;
+        m_size = 0;
+        m_zobrist = 0;
+        if (cards.size() > CAPACITY) return false;
+        for (const CardData& card : cards) {
+            if (!addCard(card.suit, card.rank)) {
+                m_present = 0;
+                m_size = 0;
+                m_zobrist = 0;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * 按相同牌序写入 Deck，供需要 CardData 序列的代码使用。
+     *
+     * @param deck 目标牌堆
+     */
+    void exportTo(Deck& deck) const {
+        // 键与统计已随在堆掩码维护，直接交给 Deck，省去逐张重算。
+        deck.restore(m_size, [this](std::span<CardData> cards) {
+            for (std::size_t i = 0; i < cards.size(); ++i) cards[i] = cardOf(m_order[i]);
+        }, m_zobrist, counts());
+    }
+
+    /**
+     * 解码单张牌。
+     *
+     * @param index 牌的编码
+     * @return 牌数据，筹码取自筹码表
+     */
+    CardData cardOf(std::uint8_t index) const {
+        const auto rank = static_cast<Rank>(index % RANKS_PER_SUIT + static_cast<int>(Rank::Two));
+        return CardData{static_cast<Suit>(index / RANKS_PER_SUIT), rank, m_chips[static_cast<std::size_t>(rank)]};
+    }
+
+private:
+    static constexpr std::uint64_t FULL_MASK = (1ULL << CAPACITY) - 1;
+
+    static constexpr std::array<std::uint8_t, CAPACITY> STANDARD_ORDER = [] {
+        std::array<std::uint8_t, CAPACITY> order{};
+        for (std::size_t i = 0; i < CAPACITY; ++i) order[i] = static_cast<std::uint8_t>(i);
+        return order;
+    }();
+
+    static constexpr std::uint64_t STANDARD_ZOBRIST = [] {
+        std::uint64_t key = 0;
+        for (int s = 0; s < 4; ++s) {
+            for (int r = static_cast<int>(Rank::Two); r <= static_cast<int>(Rank::Ace); ++r) {
+                key += Zobrist::Card(static_cast<Suit>(s), static_cast<Rank>(r));
+            }
+        }
+        return key;
+    }();
+
+    std::array<std::uint8_t, CAPACITY> m_order{};
+    std::uint8_t m_size = 0;
+    ChipTable m_chips{};
+    std::uint64_t m_present = 0;
+    std::uint64_t m_zobrist = 0;
+};
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 基于 Philox4x32-10 的计数器随机流。
+ *
+ * 输出只由 (种子, 流编号, 位置) 决定，不依赖历史调用，
+ * 因此跳转任意步数与派生子流都是 O(1)，状态可直接按值复制。
+ * 不同流编号在计数器高位上互不重叠，多线程各持一份即可无锁使用。
+ */
+class RngStream {
+public:
+    RngStream() = default;
+
+    /**
+     * 构造随机流。
+     *
+     * @param seed 种子
+     * @param streamId 流编号
+     */
+    RngStream(std::uint64_t seed, std::uint64_t streamId) : m_seed(seed), m_streamId(streamId) {}
+
+    /**
+     * 生成 32 位随机数。
+     *
+     * @return 随机数
+     */
+    std::uint32_t next32() {
+        const std::uint64_t block = m_position >> 2;
+        if (!m_cacheValid || block != m_cachedBlock) {
+            m_cache = generateBlock(block);
+            m_cachedBlock = block;
+            m_cacheValid = true;
+        }
+        return m_cache[m_position++ & 3];
+    }
+
+    /**
+     * 生成 64 位随机数。
+     *
+     * @return 随机数
+     */
+    std::uint64_t next64() {
+        const std::uint64_t hi = next32();
+        return (hi << 32) | next32();
+    }
+
+    /**
+     * 生成 [0, bound) 内的均匀整数。
+     *
+     * 使用乘法取高位并拒绝少量偏置样本，避免取模带来的偏差。
+     *
+     * @param bound 上界，必须大于 0 且不超过 2^32
+     * @return 随机下标
+     */
+    std::size_t uniform(std::size_t bound) {
+        assert(bound > 0 && bound <= 0x100000000ULL && "RngStream::uniform bound out of range");
+        const auto range = static_cast<std::uint64_t>(bound);
+        std::uint64_t product = static_cast<std::uint64_t>(next32()) * range;
+        auto low = static_cast<std::uint32_t>(product);
+        if (low < range) {
+            const auto threshold = static_cast<std::uint32_t>((0x100000000ULL - range) % range);
+            while (low < threshold) {
+                product = static_cast<std::uint64_t>(next32()) * range;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::size_t>(product >> 32);
+    }
+
+    /**
+     * 向前跳过若干个 32 位输出。
+     *
+     * @param count 跳过数量
+     */
+    void discard(std::uint64_t count) { m_position += count; }
+
+    /**
+     * 派生独立子流。
+     *
+     * 子流与父流同种子、流编号由父流编号与子编号混合得到，
+     * 不消耗父流的输出。
+     *
+     * @param childId 子编号
+     * @return 子流
+     */
+    RngStream fork(std::uint64_t childId) const {
+        return RngStream(m_seed, mix64(m_streamId ^ mix64(childId + 0x9E3779B97F4A7C15ULL)));
+    }
+
+    std::uint64_t seed() const { return m_seed; }
+    std::uint64_t streamId() const { return m_streamId; }
+
+    /**
+     * 获取已产生的 32 位输出数量。
+     *
+     * @return 位置
+     */
+    std::uint64_t position() const { return m_position; }
+
+    /**
+     * 计算 Philox4x32-10 的一个输出块。
+     *
+     * @param seed 种子（密钥）
+     * @param streamId 流编号（计数器高 64 位）
+     * @param block 块序号（计数器低 64 位）
+     * @return 4 个 32 位输出
+     */
+    static std::array<std::uint32_t, 4> Philox(std::uint64_t seed, std::uint64_t streamId, std::uint64_t block) {
+        constexpr std::uint32_t M0 = 0xD2511F53u;
+        constexpr std::uint32_t M1 = 0xCD9E8D57u;
+        constexpr std::uint32_t W0 = 0x9E3779B9u;
+        constexpr std::uint32_t W1 = 0xBB67AE85u;
+
+        std::array<std::uint32_t, 4> c = {
+            static_cast<std::uint32_t>(block),
+            static_cast<std::uint32_t>(block >> 32),
+            static_cast<std::uint32_t>(streamId),
+            static_cast<std::uint32_t>(streamId >> 32),
+        };
+        std::uint32_t k0 = static_cast<std::uint32_t>(seed);
+        std::uint32_t k1 = static_cast<std::uint32_t>(seed >> 32);
+
+        for (int round = 0; round < 10; ++round) {
+            const std::uint64_t p0 = static_cast<std::uint64_t>(M0) * c[0];
+            const std::uint64_t p1 = static_cast<std::uint64_t>(M1) * c[2];
+            c = {
+                static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k0,
+                static_cast<std::uint32_t>(p1),
+                static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k1,
+                static_cast<std::uint32_t>(p0),
+            };
+            k0 += W0;
+            k1 += W1;
+        }
+        return c;
+    }
+
+private:
+    static constexpr std::uint64_t mix64(std::uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    std::array<std::uint32_t, 4> generateBlock(std::uint64_t block) const {
+        return Philox(m_seed, m_streamId, block);
+    }
+
+    std::uint64_t m_seed = 0;
+    std::uint64_t m_streamId = 0;
+    std::uint64_t m_position = 0;
+
+    // 最近一次生成的输出块，只是缓存，不影响输出序列。
+    std::array<std::uint32_t, 4> m_cache{};
+    std::uint64_t m_cachedBlock = 0;
+    bool m_cacheValid = false;
+};
+
+/**
+ * 随机流用途。
+ *
+ * 各用途使用独立流，某一环节多取或少取随机数不会扰动其他环节，
+ * 回放与种子搜索因此只需记录一个种子。
+ */
+enum class RngStreamId : std::uint8_t {
+    Deck,
+    Shop,
+    Effects,
+    Count
+};
+
+/**
+ * 单局随机服务。
+ *
+ * 由一个种子派生全部命名流，挂在 GameContext 上随局面一起复制。
+ */
+class RngService {
+public:
+    static constexpr std::size_t STREAM_COUNT = static_cast<std::size_t>(RngStreamId::Count);
+
+    /**
+     * 以种子构造。
+     *
+     * @param seed 种子
+     */
+    explicit RngService(std::uint64_t seed = 0) { reseed(seed); }
+
+    /**
+     * 命名流的流编号，供不构造整个服务、只需单条流的批量代码使用。
+     *
+     * @param id 用途
+     * @return 流编号
+     */
+    static constexpr std::uint64_t StreamNumber(RngStreamId id) { return static_cast<std::uint64_t>(id) + 1; }
+
+    /**
+     * 重置种子，所有流回到起点。
+     *
+     * @param seed 种子
+     */
+    void reseed(std::uint64_t seed) {
+        m_seed = seed;
+        for (std::size_t i = 0; i < STREAM_COUNT; ++i) {
+            m_streams[i] = RngStream(seed, StreamNumber(static_cast<RngStreamId>(i)));
+        }
+    }
+
+    std::uint64_t seed() const { return m_seed; }
+
+    /**
+     * 获取命名流。
+     *
+     * @param id 用途
+     * @return 随机流
+     */
+    RngStream& stream(RngStreamId id) { return m_streams[static_cast<std::size_t>(id)]; }
+    const RngStream& stream(RngStreamId id) const { return m_streams[static_cast<std::size_t>(id)]; }
+
+private:
+    std::uint64_t m_seed = 0;
+    std::array<RngStream, STREAM_COUNT> m_streams{};
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "../Objects/CardModel.hpp"
+
+/**
+ * 局面的 Zobrist 键。
+ *
+ * 每个区域（牌堆、手牌、Joker、商品）维护一个多重集键：成员键按 64 位回绕加法累积，
+ * 牌移入移出时加减一次即可增量更新，重复的牌也不会像异或那样互相抵消。
+ * 整局键把各区域键按区域盐混合后与计数器键异或，组合本身是 O(1)。
+ */
+namespace Zobrist {
+
+/**
+ * 计数器字段，用于区分不同计数器的同一取值。
+ */
+enum class Field : std::uint8_t {
+    State,
+    HandsLeft,
+    DiscardsLeft,
+    Money,
+    CurrentScore,
+    TargetScore,
+    RoundsCleared,
+    DeckDrawn,
+    Count
+};
+
+/**
+ * 区域编号，同一成员在不同区域的键互不相同。
+ */
+enum class Zone : std::uint8_t {
+    Deck,
+    Hand,
+    Jokers,
+    Offers,
+    Count
+};
+
+/**
+ * SplitMix64 终混函数。
+ *
+ * @param x 输入
+ * @return 混合后的 64 位值
+ */
+constexpr std::uint64_t Mix(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+namespace detail {
+
+// 下标为 (花色 << 4) | 点数，覆盖含 Suit::None 在内的全部组合。
+constexpr std::array<std::uint64_t, 80> CARD_KEYS = [] {
+    std::array<std::uint64_t, 80> keys{};
+    for (std::size_t i = 0; i < keys.size(); ++i) keys[i] = Mix(0xC0FFEE0000000000ULL + i);
+    return keys;
+}();
+
+constexpr std::uint64_t FIELD_SALT = 0x5A17F1E1D0000000ULL;
+constexpr std::uint64_t ZONE_SALT = 0x2E0E5A1700000000ULL;
+constexpr std::uint64_t JOKER_SALT = 0x10CE500000000000ULL;
+
+} // namespace detail
+
+/**
+ * 单张牌的成员键，只取决于花色与点数。
+ *
+ * @param suit 花色
+ * @param rank 点数
+ * @return 成员键
+ */
+constexpr std::uint64_t Card(Suit suit, Rank rank) {
+    return detail::CARD_KEYS[(static_cast<std::size_t>(suit) << 4) | static_cast<std::size_t>(rank)];
+}
+
+/**
+ * Joker 的成员键。
+ *
+ * 无界面模拟以排序 Joker ID 池下标为身份，slot 区分编队位置，
+ * 使效果顺序不同的编队得到不同的键。
+ *
+ * @param poolIndex Joker 池下标
+ * @param slot 编队位置
+ * @return 成员键
+ */
+constexpr std::uint64_t Joker(std::uint64_t poolIndex, std::uint64_t slot) {
+    return Mix(detail::JOKER_SALT ^ (slot << 32) ^ poolIndex);
+}
+
+/**
+ * 商品的成员键，同一 Joker 标价不同视为不同商品。
+ *
+ * @param poolIndex Joker 池下标
+ * @param slot 商品位置
+ * @param cost 标价
+ * @return 成员键
+ */
+constexpr std::uint64_t Offer(std::uint64_t poolIndex, std::uint64_t slot, std::int64_t cost) {
+    return Mix(Joker(poolIndex, slot) ^ static_cast<std::uint64_t>(cost));
+}
+
+/**
+ * 计数器键。
+ *
+ * @param field 字段
+ * @param value 取值
+ * @return 计数器键
+ */
+constexpr std::uint64_t Counter(Field field, std::int64_t value) {
+    return Mix(detail::FIELD_SALT ^ (static_cast<std::uint64_t>(field) << 56) ^ Mix(static_cast<std::uint64_t>(value)));
+}
+
+/**
+ * 把区域多重集键混合为可与其他键异或的分量。
+ *
+ * 空区域也会得到非零分量，因此“牌在手牌”与“牌在牌堆”不会相互抵消。
+ *
+ * @param zone 区域
+ * @param setKey 区域内成员键之和
+ * @return 区域分量
+ */
+constexpr std::uint64_t InZone(Zone zone, std::uint64_t setKey) {
+    return Mix(setKey ^ (detail::ZONE_SALT + static_cast<std::uint64_t>(zone)));
+}
+
+} // namespace Zobrist
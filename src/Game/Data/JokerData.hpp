@@ -1,7 +1,10 @@
 #pragma once
+#include <memory>
 #include <string>
 #include <nlohmann/json.hpp>
 
+#include "../Effects/JokerProgram.hpp"
+
 using json = nlohmann::json;
 
 /**
@@ -19,4 +22,7 @@ struct JokerData {
     
     std::string effectId;
     json params;
+
+    // effect_id 为 "Expr" 时在加载阶段编译，同类 Joker 实例共享。
+    std::shared_ptr<const JokerProgram> program;
 };
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+
+#include "EffectContext.hpp"
+#include "JokerProgram.hpp"
+
+/**
+ * 内置效果种类。
+ *
+ * 内置效果是封闭集合，结算时按种类分支求值，
+ * 不经过虚调用与 std::optional 返回值。
+ */
+enum class BuiltinEffectKind : std::uint8_t {
+    SimpleMult,
+    SuitMult,
+    AbstractJoker,
+    DiscardRebate,
+    Script
+};
+
+/**
+ * 内置效果参数。
+ *
+ * 平铺的定长数据，可按值存入效果流水线的连续数组。
+ * 各字段是否有效取决于 kind。
+ */
+struct BuiltinEffect {
+    BuiltinEffectKind kind = BuiltinEffectKind::SimpleMult;
+    int amount = 0;          // 倍率增量、每张 Joker 倍率或返利金额
+    Suit suit = Suit::None;  // 仅 SuitMult 使用
+    Rank rank = Rank::Two;   // 仅 DiscardRebate 使用
+    const JokerProgram* program = nullptr;  // 仅 Script 使用，由效果对象持有
+};
+
+/**
+ * 查询内置效果响应的触发阶段。
+ *
+ * @param effect 内置效果
+ * @return 触发阶段位集合
+ */
+constexpr TriggerMask BuiltinTriggers(const BuiltinEffect& effect) {
+    switch (effect.kind) {
+        case BuiltinEffectKind::SimpleMult:    return TriggerBit(TriggerType::Global);
+        case BuiltinEffectKind::SuitMult:      return TriggerBit(TriggerType::Individual);
+        case BuiltinEffectKind::AbstractJoker: return TriggerBit(TriggerType::Global);
+        case BuiltinEffectKind::DiscardRebate: return TriggerBit(TriggerType::OnDiscard);
+        case BuiltinEffectKind::Script:        return effect.program ? effect.program->triggers : 0;
+    }
+    return 0;
+}
+
+/**
+ * 计算内置效果。
+ *
+ * 与 IEffect::Calculate 语义一致，但结果写入调用方提供的对象，
+ * 供计分热路径直接分支调用。
+ *
+ * @param effect 内置效果
+ * @param ctx 触发上下文
+ * @param out 触发时写入的结果
+ * @return 是否触发
+ */
+inline bool EvaluateBuiltin(const BuiltinEffect& effect, const EffectContext& ctx, EffectResult& out) {
+    switch (effect.kind) {
+        case BuiltinEffectKind::SimpleMult:
+            // 仅在全局阶段触发，目的是与逐牌阶段区分职责，避免重复加成。
+            if (ctx.trigger != TriggerType::Global) return false;
+            out = EffectResult{.triggered = true, .mult_add = effect.amount};
+            return true;
+
+        case BuiltinEffectKind::SuitMult:
+            // 仅在逐牌阶段检查当前计分牌花色，保证与设计中的“单牌触发”一致。
+            if (ctx.trigger != TriggerType::Individual ||
+                !ctx.has_other_card_snapshot ||
+                ctx.other_card_snapshot.suit != effect.suit) {
+                return false;
+            }
+            out = EffectResult{.triggered = true, .mult_add = effect.amount};
+            return true;
+
+        case BuiltinEffectKind::AbstractJoker:
+            // 该效果语义依赖“整体编队”，因此只在全局阶段按 Joker 数量叠加。
+            if (ctx.trigger != TriggerType::Global) return false;
+            out = EffectResult{.triggered = true, .mult_add = ctx.joker_count * effect.amount};
+            return true;
+
+        case BuiltinEffectKind::DiscardRebate:
+            // 仅在弃牌阶段且目标点数匹配时触发，避免在其他结算链路误加金钱。
+            if (ctx.trigger != TriggerType::OnDiscard ||
+                !ctx.has_other_card_snapshot ||
+                ctx.other_card_snapshot.rank != effect.rank) {
+                return false;
+            }
+            out = EffectResult{.triggered = true, .dollars_add = effect.amount};
+            return true;
+
+        case BuiltinEffectKind::Script:
+            return effect.program && RunJokerProgram(*effect.program, ctx, out);
+    }
+    return false;
+}
@@ -1,12 +1,10 @@
 #pragma once
 
-#include <string>
-#include <vector>
+#include <cstdint>
+#include <span>
 
 #include "../Systems/CardSnapshot.hpp"
 
-class CardArea;
-
 /**
  * 效果触发阶段。
  *
@@ -21,8 +19,25 @@ enum class TriggerType {
     OnShopEntry,
 };
 
+constexpr int TRIGGER_TYPE_COUNT = static_cast<int>(TriggerType::OnShopEntry) + 1;
+
+/**
+ * 触发阶段位集合。
+ *
+ * 效果声明自己可能响应的阶段后，计分链路只需访问相关效果。
+ */
+using TriggerMask = std::uint8_t;
+
+constexpr TriggerMask TriggerBit(TriggerType trigger) {
+    return static_cast<TriggerMask>(1u << static_cast<int>(trigger));
+}
+
+constexpr TriggerMask ALL_TRIGGERS = static_cast<TriggerMask>((1u << TRIGGER_TYPE_COUNT) - 1);
+
 /**
  * 单次效果计算结果。
+ *
+ * 只含定长数值，展示文本由 ScoreTrace 按需生成，结算过程因此不分配内存。
  */
 struct EffectResult {
     bool triggered = false;
@@ -30,21 +45,21 @@ struct EffectResult {
     int mult_add = 0;
     float x_mult = 1.0f;
     int dollars_add = 0;
-    std::string message;
 };
 
 /**
  * 效果计算上下文。
  *
- * 保留快照与区域指针是为了让效果可读取必要玩法信息，
- * 同时避免直接依赖渲染对象。
+ * 只保留快照与计数，让效果可读取必要玩法信息，
+ * 同时不依赖渲染对象与卡牌区域，无界面模拟也能构造。
+ * 快照以 span 引用调用方持有的存储，构建上下文时不复制牌数据。
  */
 struct EffectContext {
     TriggerType trigger;
 
-    std::vector<CardSnapshot> scoring_snapshots;
-    CardArea* joker_area = nullptr;
-    CardArea* hand_area = nullptr;
+    std::span<const CardSnapshot> scoring_snapshots;
+    std::span<const CardSnapshot> held_snapshots;  // 出牌时未打出的手牌
+    int joker_count = 0;  // Joker 数量，结算前一次性写入
 
     CardSnapshot other_card_snapshot;
     bool has_other_card_snapshot = false;
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "IEffect.hpp"
+
+/**
+ * 已编译的单个效果绑定。
+ *
+ * 裸指针由效果来源（Joker 区或无界面编队）的所有权保证有效，
+ * 来源内容变化时整个流水线会重建。
+ * 内置效果的参数按值内联，结算时无需解引用效果对象。
+ */
+struct EffectBinding {
+    const Card* source = nullptr;  // 无界面编队中为空
+    IEffect* effect = nullptr;
+    std::int16_t slot = 0;  // 来源在编队中的位置
+    bool builtin = false;   // 为真时按 spec 分支求值，不调用 effect
+    BuiltinEffect spec;
+};
+
+/**
+ * 按触发阶段分桶的效果流水线。
+ *
+ * 编队变化时一次性按 IEffect::Triggers 分桶，结算时每个阶段只遍历
+ * 可能触发的效果，避免对无关效果做虚调用与共享指针拷贝。
+ * 每个桶是连续数组，内置效果在其中直接分支求值，只有自定义效果才走虚调用。
+ *
+ * 流水线只依赖效果接口，不依赖卡牌渲染对象，
+ * 图形界面与无界面模拟可以共用同一条计分链路。
+ */
+class EffectPipeline {
+public:
+    /**
+     * 清空全部绑定。
+     */
+    void clear() {
+        for (auto& bucket : m_buckets) bucket.clear();
+        m_slotCount = 0;
+    }
+
+    /**
+     * 按编队顺序追加一个槽位。
+     *
+     * 无效果的槽位也占用位置，使 slot 与编队下标一致、Joker 数量计数准确。
+     * 自定义（非内置）效果的 Calculate 会收到 *source，因此必须提供来源卡牌。
+     *
+     * @param effect 槽位上的效果，可为空
+     * @param source 来源卡牌，无界面编队中为空
+     */
+    void add(IEffect* effect, const Card* source = nullptr) {
+        const auto slot = static_cast<std::int16_t>(m_slotCount++);
+        if (!effect) return;
+
+        EffectBinding binding;
+        binding.source = source;
+        binding.effect = effect;
+        binding.slot = slot;
+        if (const BuiltinEffect* spec = effect->Builtin()) {
+            binding.builtin = true;
+            binding.spec = *spec;
+        }
+        const TriggerMask triggers = effect->Triggers();
+        for (int t = 0; t < TRIGGER_TYPE_COUNT; ++t) {
+            if (triggers & TriggerBit(static_cast<TriggerType>(t))) {
+                m_buckets[static_cast<std::size_t>(t)].push_back(binding);
+            }
+        }
+    }
+
+    /**
+     * 获取指定阶段的效果列表。
+     *
+     * @param trigger 触发阶段
+     * @return 按编队顺序排列的效果绑定
+     */
+    std::span<const EffectBinding> forTrigger(TriggerType trigger) const {
+        return m_buckets[static_cast<std::size_t>(trigger)];
+    }
+
+    /**
+     * 获取编队槽位数，即 Joker 数量。
+     *
+     * @return 槽位数
+     */
+    int slotCount() const { return m_slotCount; }
+
+private:
+    std::array<std::vector<EffectBinding>, TRIGGER_TYPE_COUNT> m_buckets;
+    int m_slotCount = 0;
+};
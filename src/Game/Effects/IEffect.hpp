@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include <optional>
+#include "BuiltinEffect.hpp"
 #include "EffectContext.hpp"
 
 /**
@@ -24,4 +25,24 @@ public:
         const Card& self, 
         const EffectContext& ctx
     ) = 0;
+
+    /**
+     * 声明效果可能响应的触发阶段。
+     *
+     * 计分链路据此预先分桶，未声明的阶段不会再调用 Calculate。
+     * 默认返回全部阶段，保证未覆写的自定义效果行为不变。
+     *
+     * @return 触发阶段位集合
+     */
+    virtual TriggerMask Triggers() const { return ALL_TRIGGERS; }
+
+    /**
+     * 获取内置效果参数。
+     *
+     * 返回非空时，效果流水线按值复制参数并以分支求值代替 Calculate 虚调用；
+     * 自定义效果保持默认的空返回，继续走虚接口。
+     *
+     * @return 内置效果参数，非内置效果返回 nullptr
+     */
+    virtual const BuiltinEffect* Builtin() const { return nullptr; }
 };
@@ -1,132 +1,98 @@
 #pragma once
 
-#include <string>
+#include <memory>
 
 #include "IEffect.hpp"
-#include "../Objects/CardArea.hpp"
 
 /**
- * 全局加倍率效果。
+ * 内置效果的 IEffect 适配基类。
+ *
+ * 规则只在 EvaluateBuiltin 中实现一次：计分链路直接读取参数做分支求值，
+ * 通过虚接口调用时也转发到同一实现，两条路径结果一致。
  */
-class SimpleMultEffect : public IEffect {
+class BuiltinEffectBase : public IEffect {
 public:
-    /**
-     * 构造效果。
-     *
-     * @param amount 触发时追加倍率
-     */
-    explicit SimpleMultEffect(int amount) : m_amount(amount) {}
-
     /**
      * 计算效果。
      *
-     * 仅在全局阶段触发，目的是与逐牌阶段区分职责，避免重复加成。
-     *
      * @param self 持有效果的卡牌
      * @param ctx 触发上下文
      * @return 触发结果
      */
     std::optional<EffectResult> Calculate([[maybe_unused]] const Card& self, const EffectContext& ctx) override {
-        if (ctx.trigger == TriggerType::Global) {
-            EffectResult res;
-            res.triggered = true;
-            res.mult_add = m_amount;
-            res.message = "+" + std::to_string(m_amount) + " Mult";
-            return res;
-        }
+        EffectResult res;
+        if (EvaluateBuiltin(m_spec, ctx, res)) return res;
         return std::nullopt;
     }
 
+    /**
+     * 声明触发阶段。
+     *
+     * @return 按效果种类确定的阶段
+     */
+    TriggerMask Triggers() const override { return BuiltinTriggers(m_spec); }
+
+    /**
+     * 获取内置效果参数。
+     *
+     * @return 参数
+     */
+    const BuiltinEffect* Builtin() const override { return &m_spec; }
+
+protected:
+    explicit BuiltinEffectBase(const BuiltinEffect& spec) : m_spec(spec) {}
+
 private:
-    int m_amount;
+    BuiltinEffect m_spec;
 };
 
 /**
- * 花色条件倍率效果。
+ * 全局加倍率效果。
  */
-class SuitMultEffect : public IEffect {
+class SimpleMultEffect : public BuiltinEffectBase {
 public:
     /**
      * 构造效果。
      *
      * @param amount 触发时追加倍率
-     * @param suit 目标花色
-     * @param suitName 展示名称
      */
-    SuitMultEffect(int amount, Suit suit, std::string suitName)
-        : m_amount(amount), m_suit(suit), m_suitName(std::move(suitName)) {}
+    explicit SimpleMultEffect(int amount)
+        : BuiltinEffectBase({.kind = BuiltinEffectKind::SimpleMult, .amount = amount}) {}
+};
 
+/**
+ * 花色条件倍率效果。
+ */
+class SuitMultEffect : public BuiltinEffectBase {
+public:
     /**
-     * 计算效果。
-     *
-     * 仅在逐牌阶段检查当前计分牌花色，保证与设计中的“单牌触发”一致。
+     * 构造效果。
      *
-     * @param self 持有效果的卡牌
-     * @param ctx 触发上下文
-     * @return 触发结果
+     * @param amount 触发时追加倍率
+     * @param suit 目标花色
      */
-    std::optional<EffectResult> Calculate([[maybe_unused]] const Card& self, const EffectContext& ctx) override {
-        if (ctx.trigger == TriggerType::Individual &&
-            ctx.has_other_card_snapshot &&
-            ctx.other_card_snapshot.suit == m_suit) {
-            EffectResult res;
-            res.triggered = true;
-            res.mult_add = m_amount;
-            res.message = "+" + std::to_string(m_amount) + " Mult (" + m_suitName + ")";
-            return res;
-        }
-        return std::nullopt;
-    }
-
-private:
-    int m_amount;
-    Suit m_suit;
-    std::string m_suitName;
+    SuitMultEffect(int amount, Suit suit)
+        : BuiltinEffectBase({.kind = BuiltinEffectKind::SuitMult, .amount = amount, .suit = suit}) {}
 };
 
 /**
  * 基于 Joker 数量叠加倍率的效果。
  */
-class AbstractJokerEffect : public IEffect {
+class AbstractJokerEffect : public BuiltinEffectBase {
 public:
     /**
      * 构造效果。
      *
      * @param amountPerJoker 每张 Joker 贡献的倍率
      */
-    explicit AbstractJokerEffect(int amountPerJoker) : m_amount(amountPerJoker) {}
-
-    /**
-     * 计算效果。
-     *
-     * 在全局阶段统计 Joker 区数量，原因是该效果语义依赖“整体编队”。
-     *
-     * @param self 持有效果的卡牌
-     * @param ctx 触发上下文
-     * @return 触发结果
-     */
-    std::optional<EffectResult> Calculate([[maybe_unused]] const Card& self, const EffectContext& ctx) override {
-        if (ctx.trigger == TriggerType::Global && ctx.joker_area) {
-            const int jokerCount = static_cast<int>(ctx.joker_area->getCards().size());
-            const int totalAdd = jokerCount * m_amount;
-
-            EffectResult res;
-            res.triggered = true;
-            res.mult_add = totalAdd;
-            res.message = "+" + std::to_string(totalAdd) + " Mult (" + std::to_string(jokerCount) + " Jokers)";
-            return res;
-        }
-        return std::nullopt;
-    }
-
-private:
-    int m_amount;
+    explicit AbstractJokerEffect(int amountPerJoker)
+        : BuiltinEffectBase({.kind = BuiltinEffectKind::AbstractJoker, .amount = amountPerJoker}) {}
 };
 
 /**
  * 弃牌返利效果。
  */
-class DiscardRebateEffect : public IEffect {
+class DiscardRebateEffect : public BuiltinEffectBase {
 public:
     /**
      * 构造效果。
@@ -135,31 +101,26 @@ public:
      * @param targetRank 目标点数
      */
     DiscardRebateEffect(int dollars, Rank targetRank)
-        : m_dollars(dollars), m_targetRank(targetRank) {}
+        : BuiltinEffectBase({.kind = BuiltinEffectKind::DiscardRebate, .amount = dollars, .rank = targetRank}) {}
+};
 
+/**
+ * 数据驱动的表达式效果。
+ *
+ * 持有共享的已编译程序，参数中只保存裸指针，
+ * 程序生命周期由本对象保证。
+ */
+class ScriptedEffect : public BuiltinEffectBase {
+public:
     /**
-     * 计算效果。
-     *
-     * 仅在弃牌阶段且目标点数匹配时触发，避免在其他结算链路误加金钱。
+     * 构造效果。
      *
-     * @param self 持有效果的卡牌
-     * @param ctx 触发上下文
-     * @return 触发结果
+     * @param program 已编译程序
      */
-    std::optional<EffectResult> Calculate([[maybe_unused]] const Card& self, const EffectContext& ctx) override {
-        if (ctx.trigger == TriggerType::OnDiscard &&
-            ctx.has_other_card_snapshot &&
-            ctx.other_card_snapshot.rank == m_targetRank) {
-            EffectResult res;
-            res.triggered = true;
-            res.dollars_add = m_dollars;
-            res.message = "+$" + std::to_string(m_dollars);
-            return res;
-        }
-        return std::nullopt;
-    }
+    explicit ScriptedEffect(std::shared_ptr<const JokerProgram> program)
+        : BuiltinEffectBase({.kind = BuiltinEffectKind::Script, .program = program.get()}),
+          m_program(std::move(program)) {}
 
 private:
-    int m_dollars;
-    Rank m_targetRank;
+    std::shared_ptr<const JokerProgram> m_program;
 };
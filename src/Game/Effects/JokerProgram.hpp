@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "EffectContext.hpp"
+
+/**
+ * Joker 表达式字节码操作码。
+ *
+ * Require* 为谓词，不满足时整段程序不触发；
+ * 其余为动作，按出现顺序累加到结果中。
+ */
+enum class JokerOpCode : std::uint8_t {
+    RequireSuit,            // 当前牌花色等于 value
+    RequireRankMask,        // 当前牌点数位于 value 掩码中，第 (rank - 2) 位
+    RequireScoringAtLeast,  // 计分牌数量 >= value
+    RequireScoringAtMost,   // 计分牌数量 <= value
+    ScaleByJokers,          // 之后的加法动作乘以 Joker 数量
+    AddChips,
+    AddMult,
+    MulMult,                // 使用 factor
+    AddDollars
+};
+
+/**
+ * 单条字节码指令。
+ */
+struct JokerOp {
+    JokerOpCode code = JokerOpCode::AddMult;
+    int value = 0;
+    float factor = 1.0f;
+};
+
+/**
+ * 已编译的 Joker 表达式。
+ *
+ * 由数据库加载时一次性编译，运行期只读，
+ * 同一配置的所有 Joker 实例共享同一份程序。
+ */
+struct JokerProgram {
+    TriggerMask triggers = 0;
+    std::vector<JokerOp> ops;
+};
+
+/**
+ * 执行 Joker 表达式。
+ *
+ * 指令为定长平铺数组，解释循环只做一次分支跳转，不分配内存。
+ *
+ * @param program 已编译程序
+ * @param ctx 触发上下文
+ * @param out 触发时写入的结果
+ * @return 是否触发
+ */
+inline bool RunJokerProgram(const JokerProgram& program, const EffectContext& ctx, EffectResult& out) {
+    if (!(program.triggers & TriggerBit(ctx.trigger))) return false;
+
+    EffectResult res;
+    res.triggered = true;
+    int scale = 1;
+    const int scoringCount = static_cast<int>(ctx.scoring_snapshots.size());
+
+    for (const JokerOp& op : program.ops) {
+        switch (op.code) {
+            case JokerOpCode::RequireSuit:
+                if (!ctx.has_other_card_snapshot ||
+                    static_cast<int>(ctx.other_card_snapshot.suit) != op.value) {
+                    return false;
+                }
+                break;
+            case JokerOpCode::RequireRankMask: {
+                if (!ctx.has_other_card_snapshot) return false;
+                const int bit = static_cast<int>(ctx.other_card_snapshot.rank) - static_cast<int>(Rank::Two);
+                if (!((op.value >> bit) & 1)) return false;
+                break;
+            }
+            case JokerOpCode::RequireScoringAtLeast:
+                if (scoringCount < op.value) return false;
+                break;
+            case JokerOpCode::RequireScoringAtMost:
+                if (scoringCount > op.value) return false;
+                break;
+            case JokerOpCode::ScaleByJokers:
+                scale = ctx.joker_count;
+                break;
+            case JokerOpCode::AddChips:
+                res.chips_add += op.value * scale;
+                break;
+            case JokerOpCode::AddMult:
+                res.mult_add += op.value * scale;
+                break;
+            case JokerOpCode::MulMult:
+                res.x_mult *= op.factor;
+                break;
+            case JokerOpCode::AddDollars:
+                res.dollars_add += op.value * scale;
+                break;
+        }
+    }
+
+    out = res;
+    return true;
+}
@@ -233,6 +233,20 @@ public:
      */
     bool isJoker() const { return m_model.effect != nullptr; }
 
+    /**
+     * 设置 Joker ID。
+     *
+     * @param id 数据库中的 Joker ID
+     */
+    void setJokerId(const std::string& id) { m_model.jokerId = id; }
+
+    /**
+     * 获取 Joker ID。
+     *
+     * @return Joker ID，普通牌为空
+     */
+    const std::string& getJokerId() const { return m_model.jokerId; }
+
     /**
      * 设置能力名。
      *
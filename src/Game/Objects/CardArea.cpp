@@ -14,11 +14,13 @@ CardArea::CardArea(float x, float y, float w, float h, LayoutType type)
 
 void CardArea::addCard(std::shared_ptr<Card> card) {
     m_cards.push_back(std::move(card));
+    invalidateEffects();
 }
 
 void CardArea::removeCard(int index) {
     if (index >= 0 && index < static_cast<int>(m_cards.size())) {
         m_cards.erase(m_cards.begin() + index);
+        invalidateEffects();
         alignCards();
     }
 }
@@ -38,6 +40,7 @@ std::shared_ptr<Card> CardArea::takeCard(Card* cardPtr) {
 
     std::shared_ptr<Card> card = *it;
     m_cards.erase(it);
+    invalidateEffects();
     alignCards();
     return card;
 }
@@ -3,6 +3,7 @@
 #include <vector>
 #include <memory>
 #include "Card.hpp"
+#include "../Effects/EffectPipeline.hpp"
 
 enum class LayoutType {
     Fan, Stack, Row, Grid
@@ -75,6 +76,30 @@ public:
         return m_cards;
     }
 
+    /**
+     * 获取按触发阶段分桶的效果流水线。
+     *
+     * 区域增删卡牌后首次访问时重建，之后直接复用缓存。
+     * 直接改写 getCards() 容器或已入区卡牌的效果时需调用 invalidateEffects。
+     *
+     * @return 效果流水线
+     */
+    const EffectPipeline& effectPipeline() {
+        if (m_effectsDirty) {
+            m_effects.clear();
+            for (const auto& card : m_cards) {
+                m_effects.add(card ? card->getModel().effect.get() : nullptr, card.get());
+            }
+            m_effectsDirty = false;
+        }
+        return m_effects;
+    }
+
+    /**
+     * 标记效果流水线失效。
+     */
+    void invalidateEffects() { m_effectsDirty = true; }
+
     /**
      * 更新区域内卡牌动画。
      *
@@ -91,6 +116,8 @@ public:
 
 private:
     std::vector<std::shared_ptr<Card>> m_cards;
+    EffectPipeline m_effects;
+    bool m_effectsDirty = true;
     sf::FloatRect m_bounds;
     LayoutType m_layoutType;
     sf::RectangleShape m_debugBox;
@@ -25,6 +25,7 @@ struct CardModel {
     bool isSelected = false;
 
     std::shared_ptr<IEffect> effect = nullptr;
+    std::string jokerId;  // 数据库中的 Joker ID，普通牌为空
     std::string abilityName = "Card";
     std::string description;
 
@@ -0,0 +1,226 @@
+#include "BatchShuffle.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BALATRO_SHUFFLE_AVX2 1
+#include <immintrin.h>
+#else
+#define BALATRO_SHUFFLE_AVX2 0
+#endif
+
+namespace {
+
+using BatchShuffle::DECK_SIZE;
+using BatchShuffle::Permutation;
+
+constexpr std::size_t MAX_STEPS = DECK_SIZE - 1;
+// 起始位置不按块对齐时，51 个输出最多跨 14 个块。
+constexpr std::size_t MAX_BLOCKS = (MAX_STEPS + 3) / 4 + 1;
+// 每轮处理的牌副数，块缓冲放在栈上。
+constexpr std::size_t TILE = 16;
+constexpr std::size_t TILE_BLOCKS = TILE * MAX_BLOCKS;
+
+constexpr Permutation IDENTITY = [] {
+    Permutation order{};
+    for (std::size_t i = 0; i < DECK_SIZE; ++i) order[i] = static_cast<std::uint8_t>(i);
+    return order;
+}();
+
+/**
+ * 一轮待生成的 Philox 块，按字段分列以便成组装载。
+ */
+struct BlockJobs {
+    std::array<std::uint64_t, TILE_BLOCKS> seed{};
+    std::array<std::uint64_t, TILE_BLOCKS> stream{};
+    std::array<std::uint64_t, TILE_BLOCKS> block{};
+    std::array<std::uint32_t, TILE_BLOCKS * 4> output{};
+    std::size_t count = 0;
+};
+
+void philoxScalar(BlockJobs& jobs, std::size_t begin) {
+    for (std::size_t i = begin; i < jobs.count; ++i) {
+        const auto words = RngStream::Philox(jobs.seed[i], jobs.stream[i], jobs.block[i]);
+        std::copy(words.begin(), words.end(), jobs.output.begin() + static_cast<std::ptrdiff_t>(i * 4));
+    }
+}
+
+#if BALATRO_SHUFFLE_AVX2
+bool cpuHasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+/**
+ * 4 个块的 Philox 状态，每个 32 位字占一个 64 bit 通道。
+ */
+struct PhiloxLanes {
+    __m256i c0, c1, c2, c3, k0, k1;
+};
+
+__attribute__((target("avx2"))) inline PhiloxLanes loadLanes(const BlockJobs& jobs, std::size_t i) {
+    const __m256i low32 = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(jobs.block.data() + i));
+    const __m256i stream = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(jobs.stream.data() + i));
+    const __m256i seed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(jobs.seed.data() + i));
+    return {
+        _mm256_and_si256(block, low32), _mm256_srli_epi64(block, 32),
+        _mm256_and_si256(stream, low32), _mm256_srli_epi64(stream, 32),
+        _mm256_and_si256(seed, low32), _mm256_srli_epi64(seed, 32),
+    };
+}
+
+__attribute__((target("avx2"))) inline void philoxRound(PhiloxLanes& s) {
+    const __m256i low32 = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    const __m256i p0 = _mm256_mul_epu32(_mm256_set1_epi64x(0xD2511F53LL), s.c0);
+    const __m256i p1 = _mm256_mul_epu32(_mm256_set1_epi64x(0xCD9E8D57LL), s.c2);
+    s.c0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p1, 32), s.c1), s.k0);
+    s.c1 = _mm256_and_si256(p1, low32);
+    s.c2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p0, 32), s.c3), s.k1);
+    s.c3 = _mm256_and_si256(p0, low32);
+    s.k0 = _mm256_and_si256(_mm256_add_epi64(s.k0, _mm256_set1_epi64x(0x9E3779B9LL)), low32);
+    s.k1 = _mm256_and_si256(_mm256_add_epi64(s.k1, _mm256_set1_epi64x(0xBB67AE85LL)), low32);
+}
+
+/**
+ * 把 4 个块的输出写回，每块 4 个 32 位字连续存放。
+ */
+__attribute__((target("avx2"))) inline void storeLanes(const PhiloxLanes& s, std::uint32_t* out) {
+    // 每个通道的低 32 位即输出字：先两两交错成 (c0, c1)、(c2, c3) 对，再按块拼接。
+    const __m256i c01 = _mm256_or_si256(s.c0, _mm256_slli_epi64(s.c1, 32));
+    const __m256i c23 = _mm256_or_si256(s.c2, _mm256_slli_epi64(s.c3, 32));
+    const __m256i lo = _mm256_unpacklo_epi64(c01, c23);  // 块 0、2
+    const __m256i hi = _mm256_unpackhi_epi64(c01, c23);  // 块 1、3
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+/**
+ * AVX2 批量计算 Philox4x32-10。
+ *
+ * 每 4 个块转置为结构数组，计数器与密钥的每个 32 位字各占一个寄存器的
+ * 64 bit 通道，_mm256_mul_epu32 恰好给出 RngStream::Philox 中的 32x32→64 乘积。
+ * 两组交替推进，用彼此独立的依赖链掩盖乘法延迟。
+ *
+ * @param jobs 待生成的块
+ * @return 已处理的块数（4 的整数倍），剩余部分由调用方走标量路径
+ */
+__attribute__((target("avx2")))
+std::size_t philoxAvx2(BlockJobs& jobs) {
+    std::size_t i = 0;
+    for (; i + 8 <= jobs.count; i += 8) {
+        PhiloxLanes a = loadLanes(jobs, i);
+        PhiloxLanes b = loadLanes(jobs, i + 4);
+        for (int round = 0; round < 10; ++round) {
+            philoxRound(a);
+            philoxRound(b);
+        }
+        storeLanes(a, jobs.output.data() + i * 4);
+        storeLanes(b, jobs.output.data() + (i + 4) * 4);
+    }
+    for (; i + 4 <= jobs.count; i += 4) {
+        PhiloxLanes a = loadLanes(jobs, i);
+        for (int round = 0; round < 10; ++round) philoxRound(a);
+        storeLanes(a, jobs.output.data() + i * 4);
+    }
+    return i;
+}
+#endif
+
+/**
+ * 逐步洗牌，与 Deck::shuffle 的取数方式完全相同。
+ */
+void shuffleStepwise(RngStream& stream, Permutation& order, std::size_t steps) {
+    order = IDENTITY;
+    for (std::size_t k = 0; k < steps; ++k) {
+        const std::size_t i = DECK_SIZE - k;
+        std::swap(order[i - 1], order[stream.uniform(i)]);
+    }
+}
+
+/**
+ * 用预先生成的输出完成一副牌的洗牌。
+ *
+ * @param outputs 从流当前位置起的连续输出
+ * @param order 输出排列
+ * @param steps 洗牌步数
+ * @return 有输出落入拒绝区时返回 false，调用方改走逐步洗牌
+ */
+bool shuffleFromOutputs(const std::uint32_t* outputs, Permutation& order, std::size_t steps) {
+    order = IDENTITY;
+    for (std::size_t k = 0; k < steps; ++k) {
+        const std::uint64_t bound = DECK_SIZE - k;
+        const std::uint64_t product = static_cast<std::uint64_t>(outputs[k]) * bound;
+        const auto low = static_cast<std::uint32_t>(product);
+        // 与 RngStream::uniform 相同的拒绝条件，先用廉价比较排除绝大多数样本。
+        if (low < bound && low < static_cast<std::uint32_t>((0x100000000ULL - bound) % bound)) return false;
+        std::swap(order[bound - 1], order[product >> 32]);
+    }
+    return true;
+}
+
+void shuffleBatch(std::span<RngStream> streams, std::span<Permutation> out, std::size_t draws, bool simd) {
+    const std::size_t steps = std::min(draws, MAX_STEPS);
+    if (steps == 0) {
+        std::fill(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(streams.size()), IDENTITY);
+        return;
+    }
+
+    BlockJobs jobs;
+    std::array<std::size_t, TILE> firstJob{};
+    for (std::size_t base = 0; base < streams.size(); base += TILE) {
+        const std::size_t tile = std::min(TILE, streams.size() - base);
+
+        jobs.count = 0;
+        for (std::size_t d = 0; d < tile; ++d) {
+            const RngStream& stream = streams[base + d];
+            const std::uint64_t first = stream.position() >> 2;
+            const std::uint64_t last = (stream.position() + steps - 1) >> 2;
+            firstJob[d] = jobs.count;
+            for (std::uint64_t block = first; block <= last; ++block) {
+                jobs.seed[jobs.count] = stream.seed();
+                jobs.stream[jobs.count] = stream.streamId();
+                jobs.block[jobs.count] = block;
+                ++jobs.count;
+            }
+        }
+
+        std::size_t done = 0;
+#if BALATRO_SHUFFLE_AVX2
+        if (simd && cpuHasAvx2()) done = philoxAvx2(jobs);
+#else
+        (void)simd;
+#endif
+        philoxScalar(jobs, done);
+
+        for (std::size_t d = 0; d < tile; ++d) {
+            RngStream& stream = streams[base + d];
+            // 同一副牌的块在 output 中连续存放，按流位置的块内偏移取起点。
+            const std::uint32_t* outputs = jobs.output.data() + firstJob[d] * 4 + (stream.position() & 3);
+            if (shuffleFromOutputs(outputs, out[base + d], steps)) {
+                stream.discard(steps);
+            } else {
+                shuffleStepwise(stream, out[base + d], steps);
+            }
+        }
+    }
+}
+
+} // namespace
+
+void BatchShuffle::Shuffle(std::span<RngStream> streams, std::span<Permutation> out, std::size_t draws) {
+    shuffleBatch(streams, out, draws, true);
+}
+
+void BatchShuffle::ShuffleScalar(std::span<RngStream> streams, std::span<Permutation> out, std::size_t draws) {
+    shuffleBatch(streams, out, draws, false);
+}
+
+bool BatchShuffle::SimdAvailable() {
+#if BALATRO_SHUFFLE_AVX2
+    return cpuHasAvx2();
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "../Core/Rng.hpp"
+
+/**
+ * 批量洗牌：一次为多副标准牌生成洗牌排列。
+ *
+ * 每副牌对应一条随机流，结果与对该流调用 Deck::shuffle（或 PackedDeck::shuffle）
+ * 逐位一致，流也按相同的数量前进，之后可以继续用于抽牌之外的随机决策。
+ *
+ * 洗牌第 k 步需要 [0, 52 - k) 内的下标，固定消耗一个 32 位输出，
+ * 因此每副牌用到的 Philox 块在洗牌前就能确定：先成批生成全部块，
+ * 再用 Lemire 乘法取高位把输出映射到下标。
+ * 支持 AVX2 的 x86-64 CPU 上 Philox 按 4 个块一组并行计算，其余平台回退到标量路径；
+ * 两条路径都是整数运算，结果逐位相同。
+ * 极少数输出落入 Lemire 拒绝区（概率约 52 / 2^32）时，该副牌改走逐步洗牌，
+ * 额外消耗的随机数与 RngStream::uniform 一致。
+ */
+namespace BatchShuffle {
+
+constexpr std::size_t DECK_SIZE = 52;
+
+/**
+ * 标准牌编码（suit * 13 + rank - 2）的排列，末尾为下一张抽到的牌。
+ */
+using Permutation = std::array<std::uint8_t, DECK_SIZE>;
+
+/**
+ * 批量洗牌，自动选择 SIMD 或标量路径。
+ *
+ * @param streams 每副牌一条随机流
+ * @param out 输出排列，长度不得小于 streams
+ * @param draws 需要确定的末尾张数，语义同 PackedDeck::shuffle
+ */
+void Shuffle(std::span<RngStream> streams, std::span<Permutation> out, std::size_t draws = DECK_SIZE);
+
+/**
+ * 批量洗牌，强制走标量路径，供核对与不支持 SIMD 的平台使用。
+ *
+ * @param streams 每副牌一条随机流
+ * @param out 输出排列，长度不得小于 streams
+ * @param draws 需要确定的末尾张数
+ */
+void ShuffleScalar(std::span<RngStream> streams, std::span<Permutation> out, std::size_t draws = DECK_SIZE);
+
+/**
+ * 当前 CPU 是否会走 SIMD 路径。
+ *
+ * @return 是否支持
+ */
+bool SimdAvailable();
+
+} // namespace BatchShuffle
@@ -0,0 +1,554 @@
+#include "BlindSolver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <thread>
+
+#include "../Systems/GameDatabase.hpp"
+#include "TranspositionTable.hpp"
+#include "WorkStealing.hpp"
+
+namespace {
+
+// 手牌与整副牌按抽牌顺序编号，状态中的手牌集合是这条序列上的位掩码。
+constexpr int MAX_SEQUENCE = 64;
+
+// 单个节点的手牌，内联存放，搜索热路径上不分配。
+using HandCards = FixedVector<CardSnapshot, GameStateSnapshot::MAX_HAND>;
+
+/**
+ * Joker 效果对单次出牌的乐观上界：加法全部先于乘法生效。
+ */
+struct JokerBound {
+    bool bounded = true;
+    double chips = 0.0;
+    double multAdd = 0.0;
+    double xMult = 1.0;
+};
+
+JokerBound boundJokers(const EffectPipeline& pipeline) {
+    JokerBound bound;
+    const int jokerCount = pipeline.slotCount();
+
+    // 每个阶段的触发次数上限：逐牌阶段最多 5 张计分牌，手持阶段最多整手牌。
+    const std::pair<TriggerType, int> phases[] = {
+        {TriggerType::Individual, HandEvaluator::MAX_PLAY_CARDS},
+        {TriggerType::HeldInHand, static_cast<int>(GameStateSnapshot::MAX_HAND)},
+        {TriggerType::Global, 1},
+    };
+    for (const auto& [trigger, times] : phases) {
+        for (const EffectBinding& binding : pipeline.forTrigger(trigger)) {
+            if (!binding.builtin) {
+                // 自定义效果无法静态估计，放弃剪枝以保证结果正确。
+                bound.bounded = false;
+                return bound;
+            }
+            const BuiltinEffect& spec = binding.spec;
+            switch (spec.kind) {
+                case BuiltinEffectKind::SimpleMult:
+                    bound.multAdd += times * std::max(spec.amount, 0);
+                    break;
+                case BuiltinEffectKind::SuitMult:
+                    bound.multAdd += times * std::max(spec.amount, 0);
+                    break;
+                case BuiltinEffectKind::AbstractJoker:
+                    bound.multAdd += times * std::max(spec.amount * jokerCount, 0);
+                    break;
+                case BuiltinEffectKind::DiscardRebate:
+                    break;
+                case BuiltinEffectKind::Script: {
+                    if (!spec.program) break;
+                    int scale = 1;
+                    for (const JokerOp& op : spec.program->ops) {
+                        switch (op.code) {
+                            case JokerOpCode::ScaleByJokers: scale = std::max(jokerCount, 1); break;
+                            case JokerOpCode::AddChips: bound.chips += times * std::max(op.value * scale, 0); break;
+                            case JokerOpCode::AddMult: bound.multAdd += times * std::max(op.value * scale, 0); break;
+                            case JokerOpCode::MulMult:
+                                if (op.factor > 1.0f) bound.xMult *= std::pow(static_cast<double>(op.factor), times);
+                                break;
+                            default: break;
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    return bound;
+}
+
+bool hasStraight(std::uint16_t rankMask) {
+    // 第 (rank - 2) 位表示点数；A 同时可作 1 参与 A-2-3-4-5。
+    const std::uint32_t mask = (static_cast<std::uint32_t>(rankMask) << 1) | ((rankMask >> 12) & 1);
+    return (mask & (mask >> 1) & (mask >> 2) & (mask >> 3) & (mask >> 4)) != 0;
+}
+
+/**
+ * 牌池统计，按牌逐张累加，用于估计牌池内单次出牌的得分上界。
+ */
+struct PoolStats {
+    std::array<int, 15> rankCounts{};
+    std::array<int, 5> suitCounts{};
+    std::array<std::uint16_t, 5> suitRanks{};
+    std::uint16_t rankMask = 0;
+    std::array<int, 5> topChips{};  // 降序的前 5 张筹码
+    int drawn = 0;                  // 已并入的牌序列前缀长度
+
+    void add(const CardSnapshot& card) {
+        const auto suit = static_cast<std::size_t>(card.suit);
+        const int bit = static_cast<int>(card.rank) - static_cast<int>(Rank::Two);
+        ++rankCounts[static_cast<std::size_t>(card.rank)];
+        ++suitCounts[suit];
+        suitRanks[suit] |= static_cast<std::uint16_t>(1u << bit);
+        rankMask |= static_cast<std::uint16_t>(1u << bit);
+        int chips = card.chips;
+        for (int& slot : topChips) {
+            if (chips > slot) std::swap(chips, slot);
+        }
+    }
+
+    /**
+     * 牌池可组成的牌型中基础值最大者，叠加最高 5 张筹码与 Joker 乐观上界。
+     */
+    long long bestScore(const JokerBound& jokers) const {
+        int pairs = 0;
+        int maxCount = 0;
+        for (int count : rankCounts) {
+            if (count >= 2) ++pairs;
+            maxCount = std::max(maxCount, count);
+        }
+        const bool flush = std::any_of(suitCounts.begin(), suitCounts.end(), [](int c) { return c >= 5; });
+        const bool straightFlush = std::any_of(suitRanks.begin(), suitRanks.end(), hasStraight);
+
+        int cardChips = 0;
+        for (int chips : topChips) cardChips += chips;
+
+        double best = 0.0;
+        const auto consider = [&](PokerHandType type, bool feasible) {
+            if (!feasible) return;
+            const BaseStats stats = HandEvaluator::GetBaseStats(type);
+            const double chips = stats.chips + cardChips + jokers.chips;
+            const double mult = (stats.mult + jokers.multAdd) * jokers.xMult;
+            best = std::max(best, chips * mult);
+        };
+        consider(PokerHandType::HighCard, true);
+        consider(PokerHandType::Pair, maxCount >= 2);
+        consider(PokerHandType::TwoPair, pairs >= 2);
+        consider(PokerHandType::ThreeOfAKind, maxCount >= 3);
+        consider(PokerHandType::Straight, hasStraight(rankMask));
+        consider(PokerHandType::Flush, flush);
+        consider(PokerHandType::FullHouse, maxCount >= 3 && pairs >= 2);
+        consider(PokerHandType::FourOfAKind, maxCount >= 4);
+        consider(PokerHandType::StraightFlush, straightFlush);
+        consider(PokerHandType::RoyalFlush, straightFlush);
+        return static_cast<long long>(std::ceil(best));
+    }
+};
+
+/**
+ * 根节点的一个候选操作。
+ */
+struct RootOption {
+    SimAction action;
+    long long score = 0;  // 出牌得分，弃牌为 0
+    long long bound = 0;  // 操作后可得累计分的上界
+};
+
+/**
+ * 待搜索的弃牌子状态，按上界降序展开。
+ */
+struct DiscardChild {
+    long long bound = 0;
+    std::uint64_t hand = 0;
+    int next = 0;
+};
+
+/**
+ * 单层搜索缓冲。每层的剩余操作数不同，同一线程递归时各层互不覆盖。
+ */
+struct SearchLevel {
+    HandCards cards;
+    std::array<int, GameStateSnapshot::MAX_HAND> positions{};
+    std::vector<PlayCandidate> plays;
+    std::vector<DiscardChild> discards;
+};
+
+class Solver {
+public:
+    Solver(const GameDatabase& database, const GameStateSnapshot& root, const SolverConfig& config)
+        : m_table(config.tableSize), m_nodeLimit(config.nodeLimit) {
+        for (const PackedCard card : root.hand) m_sequence.push_back(GameStateSnapshot::Unpack(card));
+        // Deck::draw 从尾部取牌，序列按抽牌先后排列。
+        for (std::size_t i = root.deck.size(); i > 0 && m_sequence.size() < MAX_SEQUENCE; --i) {
+            m_sequence.push_back(GameStateSnapshot::Unpack(root.deck[i - 1]));
+        }
+        for (const CardSnapshot& card : m_sequence) m_cardKeys.push_back(Zobrist::Card(card.suit, card.rank));
+
+        std::vector<std::string> pool = database.getAllJokerIds();
+        std::sort(pool.begin(), pool.end());
+        for (std::uint8_t index : root.jokers) {
+            if (index >= pool.size()) continue;
+            m_effects.push_back(database.createJokerEffect(pool[index]));
+            m_pipeline.add(m_effects.back().get());
+        }
+        m_jokerBound = boundJokers(m_pipeline);
+
+        m_rootHand = root.hand.size() >= 64 ? ~0ULL : (1ULL << root.hand.size()) - 1;
+        m_rootNext = static_cast<int>(root.hand.size());
+        m_need = std::max<long long>(root.targetScore - root.currentScore, 1);
+
+        if (config.timeLimitMs > 0) {
+            m_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.timeLimitMs);
+            m_hasDeadline = true;
+        }
+
+        // 每个工作线程一组逐层缓冲，层号为剩余出牌数与弃牌数之和。
+        const unsigned workers = config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+        const std::size_t depth = static_cast<std::size_t>(std::max<int>(root.handsLeft, 0) + std::max<int>(root.discardsLeft, 0)) + 1;
+        m_levels.resize(workers);
+        for (auto& levels : m_levels) levels.resize(depth);
+    }
+
+    long long need() const { return m_need; }
+    std::uint64_t rootHand() const { return m_rootHand; }
+    int rootNext() const { return m_rootNext; }
+    long long nodes() const { return m_nodes.load(std::memory_order_relaxed); }
+    bool aborted() const { return m_aborted.load(std::memory_order_relaxed); }
+
+    /**
+     * 在窗口 (alpha, beta) 内计算状态价值：至多 plays 次出牌、discards 次弃牌可得的最大累计分，
+     * 封顶于所需分数。
+     *
+     * 返回 r：r <= alpha 时真实值不大于 alpha；r >= beta 时真实值不小于 r；否则 r 即真实值。
+     * 出牌按得分降序、弃牌按子状态上界降序展开，上界不超过 max(alpha, 已有解) 的分支全部剪掉，
+     * 子状态沿用收窄后的窗口，因此深层也能按祖先已有的解剪枝。
+     *
+     * @param beta 不超过所需分数
+     * @param worker 调用线程编号，决定使用哪一组缓冲
+     */
+    long long value(std::uint64_t hand, int next, int plays, int discards, long long alpha, long long beta,
+                    unsigned worker) {
+        // 本次出牌已够过关时后续价值无关紧要，0 即满足 r >= beta 的约定。
+        if (plays <= 0 || hand == 0 || beta <= 0) return 0;
+
+        const std::uint64_t key = zobrist(hand, next, plays, discards);
+        TtEntry cached;
+        if (m_table.probe(key, cached)) {
+            if (cached.bound == TtEntry::Bound::Exact) return cached.value;
+            if (cached.bound == TtEntry::Bound::Lower && cached.value >= beta) return cached.value;
+            if (cached.bound == TtEntry::Bound::Upper && cached.value <= alpha) return cached.value;
+        }
+
+        // 上界已不超过下限时无需展开，上界本身即满足 r <= alpha 的约定。
+        long long restBound = 0;
+        const long long bound = reachBound(hand, next, plays, discards, &restBound);
+        if (bound <= alpha) return bound;
+
+        const long long expanded = m_nodes.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (m_nodeLimit > 0 && expanded > m_nodeLimit) m_aborted.store(true, std::memory_order_relaxed);
+        if (m_hasDeadline && (expanded & 0xFF) == 0 && std::chrono::steady_clock::now() > m_deadline) {
+            m_aborted.store(true, std::memory_order_relaxed);
+        }
+        if (aborted()) return 0;
+
+        SearchLevel& level = m_levels[worker][static_cast<std::size_t>(plays + discards)];
+        collectHand(hand, level.cards, level.positions);
+        // 最后一手只需最高分，后续价值为 0。
+        HandEvaluator::EnumerateBestPlays(level.cards, &m_pipeline, plays == 1 ? 1 : SIZE_MAX, level.plays);
+        long long best = 0;
+        for (const auto& play : level.plays) {
+            const long long floor = std::max(alpha, best);
+            // 候选按得分降序，当前出牌加其余出牌上界都不超过下限时，其后也不会超过。
+            if (play.final_score + restBound <= floor) break;
+            const auto [childHand, childNext] = advance(hand, next, play.card_mask, level.positions);
+            if (play.final_score + reachBound(childHand, childNext, plays - 1, discards) <= floor) continue;
+            const long long child = value(childHand, childNext, plays - 1, discards,
+                                          floor - play.final_score, beta - play.final_score, worker);
+            best = std::max(best, std::min(m_need, play.final_score + child));
+            if (best >= beta) break;
+        }
+
+        if (best < beta && discards > 0 && bound > std::max(alpha, best)) {
+            // 每个弃牌子状态用自己的可达牌池求上界：弃掉的牌离开牌池，剩余弃牌数也少一次。
+            level.discards.clear();
+            const std::uint32_t subsetCount = 1u << level.cards.size();
+            for (std::uint32_t mask = 1; mask < subsetCount; ++mask) {
+                if (std::popcount(mask) > HandEvaluator::MAX_PLAY_CARDS) continue;
+                const auto [childHand, childNext] = advance(hand, next, static_cast<std::uint16_t>(mask), level.positions);
+                const long long childBound = reachBound(childHand, childNext, plays, discards - 1);
+                if (childBound > std::max(alpha, best)) level.discards.push_back({childBound, childHand, childNext});
+            }
+            std::sort(level.discards.begin(), level.discards.end(), [](const DiscardChild& a, const DiscardChild& b) {
+                return a.bound > b.bound;
+            });
+            for (const DiscardChild& child : level.discards) {
+                const long long floor = std::max(alpha, best);
+                if (child.bound <= floor) break;
+                best = std::max(best, value(child.hand, child.next, plays, discards - 1, floor, beta, worker));
+                if (best >= beta) break;
+            }
+        }
+
+        // 触顶中止时结果不可靠，不能写入置换表。
+        if (!aborted()) {
+            TtEntry entry{.value = best, .depth = plays + discards};
+            if (best <= alpha) {
+                entry = TtEntry{.value = alpha, .depth = plays + discards, .bound = TtEntry::Bound::Upper};
+            } else if (best >= beta) {
+                entry.bound = TtEntry::Bound::Lower;
+            }
+            m_table.store(key, entry);
+        }
+        return best;
+    }
+
+    /**
+     * 列出根状态的全部出牌与弃牌，附带各自的上界，按上界降序排列。
+     */
+    std::vector<RootOption> options(std::uint64_t hand, int next, int plays, int discards) const {
+        std::vector<RootOption> out;
+        HandCards cards;
+        std::array<int, GameStateSnapshot::MAX_HAND> positions{};
+        collectHand(hand, cards, positions);
+
+        if (plays > 0) {
+            for (const auto& play : HandEvaluator::EnumerateBestPlays(cards, &m_pipeline, SIZE_MAX)) {
+                const auto [childHand, childNext] = advance(hand, next, play.card_mask, positions);
+                const long long bound = std::min(m_need, play.final_score + reachBound(childHand, childNext, plays - 1, discards));
+                out.push_back({{.kind = SimAction::Kind::Play, .cardMask = play.card_mask}, play.final_score, bound});
+            }
+        }
+        if (discards > 0) {
+            const std::uint32_t subsetCount = 1u << cards.size();
+            for (std::uint32_t mask = 1; mask < subsetCount; ++mask) {
+                if (std::popcount(mask) > HandEvaluator::MAX_PLAY_CARDS) continue;
+                const auto [childHand, childNext] = advance(hand, next, static_cast<std::uint16_t>(mask), positions);
+                const long long bound = reachBound(childHand, childNext, plays, discards - 1);
+                out.push_back({{.kind = SimAction::Kind::Discard, .cardMask = static_cast<std::uint16_t>(mask)}, 0, bound});
+            }
+        }
+        std::stable_sort(out.begin(), out.end(), [](const RootOption& a, const RootOption& b) { return a.bound > b.bound; });
+        return out;
+    }
+
+    /**
+     * 执行一个操作后的子状态。
+     */
+    std::pair<std::uint64_t, int> apply(std::uint64_t hand, int next, std::uint16_t cardMask) const {
+        HandCards cards;
+        std::array<int, GameStateSnapshot::MAX_HAND> positions{};
+        collectHand(hand, cards, positions);
+        return advance(hand, next, cardMask, positions);
+    }
+
+    /**
+     * 在窗口 (alpha, beta) 内计算根操作的价值（出牌已计入本次得分），返回值语义同 value。
+     */
+    long long optionValue(std::uint64_t hand, int next, int plays, int discards, const RootOption& option,
+                          long long alpha, long long beta, unsigned worker) {
+        const auto [childHand, childNext] = apply(hand, next, option.action.cardMask);
+        if (option.action.kind == SimAction::Kind::Play) {
+            const long long child = value(childHand, childNext, plays - 1, discards,
+                                          alpha - option.score, beta - option.score, worker);
+            return std::min(m_need, option.score + child);
+        }
+        return value(childHand, childNext, plays, discards - 1, alpha, beta, worker);
+    }
+
+private:
+    /**
+     * 状态键：手牌按牌面取多重集键，剩余牌由已抽张数唯一确定。
+     *
+     * 不同操作顺序得到同一手牌与抽牌进度时键相同，子问题只求一次。
+     */
+    std::uint64_t zobrist(std::uint64_t hand, int next, int plays, int discards) const {
+        std::uint64_t handKey = 0;
+        for (std::uint64_t m = hand; m != 0; m &= m - 1) {
+            handKey += m_cardKeys[static_cast<std::size_t>(std::countr_zero(m))];
+        }
+        return Zobrist::InZone(Zobrist::Zone::Hand, handKey) ^
+               Zobrist::Counter(Zobrist::Field::DeckDrawn, next) ^
+               Zobrist::Counter(Zobrist::Field::HandsLeft, plays) ^
+               Zobrist::Counter(Zobrist::Field::DiscardsLeft, discards);
+    }
+
+    void collectHand(std::uint64_t hand, HandCards& cards,
+                     std::array<int, GameStateSnapshot::MAX_HAND>& positions) const {
+        cards.clear();
+        // 手牌按序列位置升序排列，与模拟器“保留原顺序、新牌追加在后”一致。
+        for (std::uint64_t m = hand; m != 0 && cards.size() < positions.size(); m &= m - 1) {
+            const int position = std::countr_zero(m);
+            positions[cards.size()] = position;
+            cards.push_back(m_sequence[static_cast<std::size_t>(position)]);
+        }
+    }
+
+    std::pair<std::uint64_t, int> advance(std::uint64_t hand, int next, std::uint16_t cardMask,
+                                          const std::array<int, GameStateSnapshot::MAX_HAND>& positions) const {
+        int removed = 0;
+        for (std::uint16_t m = cardMask; m != 0; m &= m - 1) {
+            hand &= ~(1ULL << positions[static_cast<std::size_t>(std::countr_zero(m))]);
+            ++removed;
+        }
+        const int sequenceSize = static_cast<int>(m_sequence.size());
+        for (int i = 0; i < removed && next < sequenceSize; ++i, ++next) {
+            hand |= 1ULL << next;
+        }
+        return {hand, next};
+    }
+
+    /**
+     * 剩余全部出牌的累计得分上界。
+     *
+     * 第 k 次出牌（从 0 计）之前至多经过 k 次出牌与全部弃牌，每次至多补 5 张，
+     * 牌池为当前手牌加上这些操作最多能抽到的牌；每次出牌取牌池可组成的牌型中
+     * 基础值最大者，叠加牌池最高 5 张筹码与 Joker 乐观上界，逐次求和。
+     *
+     * @param rest 写入第一次出牌之后其余出牌的累计上界，即打出一手后子状态上界的上界
+     * @return 封顶于所需分数
+     */
+    long long reachBound(std::uint64_t hand, int next, int plays, int discards, long long* rest = nullptr) const {
+        if (rest) *rest = m_need;
+        if (!m_jokerBound.bounded) return m_need;
+        if (plays <= 0) {
+            if (rest) *rest = 0;
+            return 0;
+        }
+
+        PoolStats pool;
+        for (std::uint64_t m = hand; m != 0; m &= m - 1) {
+            pool.add(m_sequence[static_cast<std::size_t>(std::countr_zero(m))]);
+        }
+        const int sequenceSize = static_cast<int>(m_sequence.size());
+        long long first = 0;
+        long long total = 0;
+        for (int k = 0; k < plays; ++k) {
+            const int reach = std::min(sequenceSize, next + HandEvaluator::MAX_PLAY_CARDS * (k + discards));
+            for (int i = std::max(next, pool.drawn); i < reach; ++i) pool.add(m_sequence[static_cast<std::size_t>(i)]);
+            pool.drawn = std::max(pool.drawn, reach);
+
+            const long long single = pool.bestScore(m_jokerBound);
+            if (k == 0) first = single;
+            total += single;
+            // 其余出牌的上界也需要时不能提前封顶返回。
+            if (!rest && total >= m_need) return m_need;
+        }
+        if (rest) *rest = std::min(m_need, total - first);
+        return std::min(m_need, total);
+    }
+
+    std::vector<CardSnapshot> m_sequence;
+    std::vector<std::uint64_t> m_cardKeys;
+    std::vector<std::shared_ptr<IEffect>> m_effects;
+    EffectPipeline m_pipeline;
+    JokerBound m_jokerBound;
+
+    std::uint64_t m_rootHand = 0;
+    int m_rootNext = 0;
+    long long m_need = 1;
+
+    TranspositionTable m_table;
+    long long m_nodeLimit = 0;
+    std::chrono::steady_clock::time_point m_deadline{};
+    bool m_hasDeadline = false;
+    std::atomic<long long> m_nodes{0};
+    std::atomic<bool> m_aborted{false};
+    std::vector<std::vector<SearchLevel>> m_levels;
+};
+
+/**
+ * 在窗口 (alpha, beta) 内并行求解根状态价值，返回值语义同 Solver::value。
+ *
+ * 根操作按上界降序分给各线程，各线程以当前最好解为下限搜索，先展开的高上界分支给出的解可以剪掉后面的分支。
+ */
+long long solveRoot(Solver& solver, int plays, int discards, long long alpha, long long beta, unsigned threads) {
+    const std::uint64_t hand = solver.rootHand();
+    const int next = solver.rootNext();
+    const auto options = solver.options(hand, next, plays, discards);
+
+    std::atomic<long long> best{alpha};
+    WorkStealing::ParallelFor(options.size(), threads, [&](std::size_t index, unsigned worker) {
+        const RootOption& option = options[index];
+        const long long floor = best.load(std::memory_order_relaxed);
+        if (floor >= beta || option.bound <= floor) return;
+
+        const long long value = std::min(beta, solver.optionValue(hand, next, plays, discards, option, floor, beta, worker));
+        long long current = best.load(std::memory_order_relaxed);
+        while (value > current && !best.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    });
+    return best.load();
+}
+
+} // namespace
+
+SolverResult BlindSolver::Solve(const GameDatabase& database, const GameStateSnapshot& root, const SolverConfig& config) {
+    SolverResult result;
+    if (root.state != GameState::Run || root.hand.empty() || root.handsLeft <= 0) return result;
+
+    Solver solver(database, root, config);
+    const int discards = std::max<int>(root.discardsLeft, 0);
+
+    // 逐步放宽出牌数，第一个能达到所需分数的出牌数即最少手数；置换表在各轮间复用。
+    // 这一阶段只需判定能否过关，以所需分数减一为下限，上界不超过它的分支全部剪掉。
+    long long value = 0;
+    int plays = 1;
+    for (; plays <= root.handsLeft; ++plays) {
+        value = solveRoot(solver, plays, discards, solver.need() - 1, solver.need(), config.threads);
+        if (value >= solver.need() || solver.aborted()) break;
+    }
+    // 确定无法过关后，再用满全部手数求精确最高分。
+    if (value < solver.need() && !solver.aborted()) {
+        value = solveRoot(solver, root.handsLeft, discards, 0, solver.need(), config.threads);
+    }
+    plays = std::min<int>(plays, root.handsLeft);
+    result.cleared = value >= solver.need();
+    result.handsUsed = plays;
+
+    // 沿价值不低于目标的操作回溯出方案：目标不超过最优值，用零宽窗口判定即可，命中置换表时无需重新搜索。
+    // 并行阶段已结束，使用 0 号缓冲。
+    std::uint64_t hand = solver.rootHand();
+    int next = solver.rootNext();
+    int playsLeft = plays;
+    int discardsLeft = discards;
+    long long target = value;
+    long long scored = 0;
+    while (playsLeft > 0 && hand != 0 && target > 0 && !solver.aborted()) {
+        bool advanced = false;
+        for (const RootOption& option : solver.options(hand, next, playsLeft, discardsLeft)) {
+            if (option.bound < target) break;
+            if (solver.optionValue(hand, next, playsLeft, discardsLeft, option, target - 1, target, 0) < target) continue;
+
+            result.plan.push_back(option.action);
+            const auto [childHand, childNext] = solver.apply(hand, next, option.action.cardMask);
+            hand = childHand;
+            next = childNext;
+            if (option.action.kind == SimAction::Kind::Play) {
+                scored += option.score;
+                target -= option.score;
+                --playsLeft;
+            } else {
+                --discardsLeft;
+            }
+            advanced = true;
+            break;
+        }
+        if (!advanced) break;
+    }
+
+    // 中止时价值不可靠、方案可能不完整，不能据此声称过关，交由调用方处理。
+    if (solver.aborted()) {
+        result.cleared = false;
+        result.plan.clear();
+    }
+    result.bestScore = scored;
+    result.exhaustive = !solver.aborted();
+    result.nodes = solver.nodes();
+    return result;
+}
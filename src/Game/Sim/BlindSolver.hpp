@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Core/GameStateSnapshot.hpp"
+#include "RunSimulator.hpp"
+
+class GameDatabase;
+
+/**
+ * 求解参数。
+ */
+struct SolverConfig {
+    unsigned threads = 0;     // 0 表示使用硬件并发数
+    long long nodeLimit = 0;  // 展开节点上限，0 表示不限；触顶时结果不保证最优
+    long long timeLimitMs = 0;  // 求解时间上限（毫秒），0 表示不限；超时处理同节点触顶
+    std::size_t tableSize = std::size_t{1} << 20;  // 置换表槽位数，被覆盖的子问题会重新搜索；每次求解都要清零整张表
+};
+
+/**
+ * 求解结果。
+ */
+struct SolverResult {
+    bool cleared = false;            // 剩余手数内能否达到目标分
+    bool exhaustive = true;          // 搜索是否完整，节点或时间触顶时为 false，此时不给出方案
+    int handsUsed = 0;               // 过关所需最少出牌数；未过关时为全部手数
+    long long bestScore = 0;         // 方案累计得分；过关时至少为所需分数
+    std::vector<SimAction> plan;     // 按顺序执行的出牌/弃牌，掩码相对当时手牌
+    long long nodes = 0;             // 展开的节点数
+};
+
+namespace BlindSolver {
+
+/**
+ * 在牌序已知时精确求解当前盲注。
+ *
+ * 已知种子时牌堆顺序固定，盲注变成确定性问题，“过关概率”只有 0 或 1，
+ * 因此目标为：能过关时使用最少出牌数，否则最大化累计得分。
+ *
+ * 以（手牌集合、已抽张数、剩余出牌数、剩余弃牌数）为状态做带窗口的记忆化深度优先搜索，
+ * 得分封顶在所需分数，使缓存值与路径无关。每次出牌的得分上界由
+ * 当时可达牌池能组成的最大牌型与 Joker 效果的乐观累加给出，逐次求和，
+ * 上界不超过窗口下限的分支直接剪掉；先以零宽窗口判定能否过关，确定无法过关后才求最高分。
+ * 根节点的候选操作按上界排序后分给全部核心并行求解，
+ * 子问题结果连同上下界类型存入以 Zobrist 键索引的无锁置换表，各线程共享。
+ *
+ * @param database 数据仓库，求解期间只读
+ * @param root 盲注中的局面，牌堆顺序视为已知
+ * @param config 求解参数
+ * @return 求解结果
+ */
+SolverResult Solve(const GameDatabase& database, const GameStateSnapshot& root, const SolverConfig& config);
+
+} // namespace BlindSolver
@@ -0,0 +1,213 @@
+#include "DiscardAdvisor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include "../Core/GameContext.hpp"
+#include "../Core/GameStateSnapshot.hpp"
+#include "../Core/Zobrist.hpp"
+#include "../Systems/HandEvaluator.hpp"
+#include "SuitIsomorphism.hpp"
+#include "WorkStealing.hpp"
+
+namespace {
+
+constexpr int FLUSH_SIZE = 5;
+constexpr int OTHER_SUIT_CLASS = SuitIsomorphism::SUIT_COUNT;
+
+/**
+ * 补牌时可互换的一组剩余牌，cards 中的牌点数与筹码相同、花色同属一个花色类。
+ */
+struct DrawGroup {
+    Rank rank = Rank::Two;
+    int chips = 0;
+    int suitClass = 0;
+    std::vector<CardSnapshot> cards;
+};
+
+double choose(int n, int k) {
+    if (k < 0 || k > n) return 0.0;
+    double result = 1.0;
+    for (int i = 1; i <= k; ++i) result = result * (n - k + i) / i;
+    return result;
+}
+
+std::vector<DrawGroup> groupDeck(std::span<const CardData> deck, SuitIsomorphism::SuitMask distinct) {
+    std::vector<DrawGroup> groups;
+    for (const CardData& card : deck) {
+        const auto suit = static_cast<unsigned>(card.suit);
+        const int suitClass = suit < SuitIsomorphism::SUIT_COUNT && (distinct & (1u << suit))
+            ? static_cast<int>(suit)
+            : OTHER_SUIT_CLASS;
+        auto it = std::find_if(groups.begin(), groups.end(), [&](const DrawGroup& g) {
+            return g.rank == card.rank && g.chips == card.baseChips && g.suitClass == suitClass;
+        });
+        if (it == groups.end()) {
+            groups.push_back(DrawGroup{card.rank, card.baseChips, suitClass, {}});
+            it = groups.end() - 1;
+        }
+        it->cards.push_back(CardSnapshot{.suit = card.suit, .rank = card.rank, .chips = card.baseChips});
+    }
+    return groups;
+}
+
+/**
+ * 单个弃牌子集的多重集枚举。
+ */
+class DrawEnumerator {
+public:
+    DrawEnumerator(const std::vector<DrawGroup>& groups, const EffectPipeline* jokers, long long need,
+                   const std::atomic<bool>* cancel)
+        : m_groups(groups), m_jokers(jokers), m_need(need), m_cancel(cancel) {
+        m_suffix.assign(groups.size() + 1, 0);
+        for (std::size_t g = groups.size(); g > 0; --g) {
+            m_suffix[g - 1] = m_suffix[g] + static_cast<int>(groups[g - 1].cards.size());
+        }
+    }
+
+    void run(std::vector<CardSnapshot>& hand, int draws) { visit(hand, 0, draws, 1.0); }
+
+    double weight = 0.0;
+    double scoreSum = 0.0;
+    double clearWeight = 0.0;
+    long long outcomes = 0;
+    bool cancelled = false;
+
+private:
+    void visit(std::vector<CardSnapshot>& hand, std::size_t group, int remaining, double w) {
+        if (cancelled) return;
+        if (remaining == 0) {
+            score(hand, w);
+            return;
+        }
+        if (m_suffix[group] < remaining) return;
+
+        const DrawGroup& g = m_groups[group];
+        const int available = static_cast<int>(g.cards.size());
+        for (int x = 0; x <= std::min(available, remaining); ++x) {
+            // 组内牌互换不影响得分，取前 x 张作代表，方案数为 C(n, x)。
+            for (int i = 0; i < x; ++i) hand.push_back(g.cards[static_cast<std::size_t>(i)]);
+            visit(hand, group + 1, remaining - x, w * choose(available, x));
+            hand.resize(hand.size() - static_cast<std::size_t>(x));
+        }
+    }
+
+    void score(const std::vector<CardSnapshot>& hand, double w) {
+        if ((++outcomes & 0xFFF) == 0 && m_cancel && m_cancel->load(std::memory_order_relaxed)) {
+            cancelled = true;
+            return;
+        }
+        const auto best = HandEvaluator::EnumerateBestPlays(hand, m_jokers, 1);
+        const long long value = best.empty() ? 0 : best.front().final_score;
+        weight += w;
+        scoreSum += w * static_cast<double>(value);
+        if (m_need > 0 && value >= m_need) clearWeight += w;
+    }
+
+    const std::vector<DrawGroup>& m_groups;
+    const EffectPipeline* m_jokers;
+    long long m_need;
+    const std::atomic<bool>* m_cancel;
+    std::vector<int> m_suffix;
+};
+
+std::uint64_t adviceKey(const std::vector<CardSnapshot>& hand, const Deck& deck,
+                        const EffectPipeline* jokers, const DiscardConfig& config) {
+    // 手牌顺序决定掩码含义，因此按位置混合；剩余牌取多重集键。
+    std::uint64_t key = Zobrist::Mix(deck.zobrist() ^ static_cast<std::uint64_t>(deck.getRemainingCount()));
+    for (const CardSnapshot& card : hand) {
+        key = Zobrist::Mix(key ^ Zobrist::Card(card.suit, card.rank) ^ static_cast<std::uint64_t>(card.chips));
+    }
+    if (jokers) {
+        key = Zobrist::Mix(key ^ static_cast<std::uint64_t>(jokers->slotCount()));
+        for (int t = 0; t < TRIGGER_TYPE_COUNT; ++t) {
+            for (const EffectBinding& binding : jokers->forTrigger(static_cast<TriggerType>(t))) {
+                key = Zobrist::Mix(key ^ reinterpret_cast<std::uintptr_t>(binding.effect) ^
+                                   static_cast<std::uint64_t>(binding.slot));
+            }
+        }
+    }
+    key = Zobrist::Mix(key ^ static_cast<std::uint64_t>(config.maxDiscard));
+    return Zobrist::Mix(key ^ static_cast<std::uint64_t>(config.need));
+}
+
+} // namespace
+
+const DiscardAdvice& DiscardAdvisor::advise(const std::vector<CardSnapshot>& hand, const Deck& deck,
+                                            const EffectPipeline* jokers, const DiscardConfig& config) {
+    const std::uint64_t key = adviceKey(hand, deck, jokers, config);
+    if (m_valid && key == m_key) return m_advice;
+
+    m_advice = DiscardAdvice{};
+    m_valid = false;
+    const int handSize = std::min(static_cast<int>(hand.size()), static_cast<int>(GameStateSnapshot::MAX_HAND));
+    const auto keep = HandEvaluator::EnumerateBestPlays(hand, jokers, 1);
+    m_advice.keepScore = keep.empty() ? 0.0 : static_cast<double>(keep.front().final_score);
+    if (handSize == 0) return m_advice;
+
+    std::vector<std::uint16_t> masks;
+    const int maxDiscard = std::clamp(config.maxDiscard, 0, HandEvaluator::MAX_PLAY_CARDS);
+    for (std::uint32_t mask = 1; mask < (1u << handSize); ++mask) {
+        if (std::popcount(mask) <= maxDiscard) masks.push_back(static_cast<std::uint16_t>(mask));
+    }
+
+    const SuitIsomorphism::SuitMask pinned = jokers ? SuitIsomorphism::PinnedSuits(*jokers) : 0;
+    std::vector<DiscardEv> results(masks.size());
+    std::vector<long long> evaluations(masks.size(), 0);
+    std::atomic<bool> cancelled{false};
+
+    WorkStealing::ParallelFor(masks.size(), config.threads, [&](std::size_t index, unsigned) {
+        if (config.cancel && config.cancel->load(std::memory_order_relaxed)) {
+            cancelled.store(true, std::memory_order_relaxed);
+            return;
+        }
+        const std::uint16_t mask = masks[index];
+
+        std::vector<CardSnapshot> kept;
+        std::array<int, SuitIsomorphism::SUIT_COUNT> keptSuits{};
+        for (int i = 0; i < handSize; ++i) {
+            if ((mask >> i) & 1) continue;
+            kept.push_back(hand[static_cast<std::size_t>(i)]);
+            const auto suit = static_cast<std::size_t>(hand[static_cast<std::size_t>(i)].suit);
+            if (suit < keptSuits.size()) ++keptSuits[suit];
+        }
+        const int draws = std::clamp(GameContext::HAND_SIZE_LIMIT - static_cast<int>(kept.size()), 0,
+                                     deck.getRemainingCount());
+
+        // 只有可能凑满同花或被效果引用的花色需要区分。
+        SuitIsomorphism::SuitMask distinct = pinned;
+        for (int s = 0; s < SuitIsomorphism::SUIT_COUNT; ++s) {
+            if (keptSuits[static_cast<std::size_t>(s)] + draws >= FLUSH_SIZE) distinct |= static_cast<SuitIsomorphism::SuitMask>(1u << s);
+        }
+        const std::vector<DrawGroup> groups = groupDeck(deck.cards(), distinct);
+
+        DrawEnumerator enumerator(groups, jokers, config.need, config.cancel);
+        kept.reserve(kept.size() + static_cast<std::size_t>(draws));
+        enumerator.run(kept, draws);
+        if (enumerator.cancelled) {
+            cancelled.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        DiscardEv& ev = results[index];
+        ev.cardMask = mask;
+        ev.outcomes = enumerator.outcomes;
+        if (enumerator.weight > 0.0) {
+            ev.expectedScore = enumerator.scoreSum / enumerator.weight;
+            ev.clearChance = enumerator.clearWeight / enumerator.weight;
+        }
+        evaluations[index] = enumerator.outcomes;
+    });
+
+    for (const long long count : evaluations) m_advice.evaluations += count;
+    m_advice.options = std::move(results);
+    std::stable_sort(m_advice.options.begin(), m_advice.options.end(), [](const DiscardEv& a, const DiscardEv& b) {
+        return a.expectedScore > b.expectedScore;
+    });
+
+    m_advice.complete = !cancelled.load();
+    m_valid = m_advice.complete;
+    m_key = key;
+    return m_advice;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "../Core/Deck.hpp"
+#include "../Effects/EffectPipeline.hpp"
+#include "../Systems/CardSnapshot.hpp"
+
+/**
+ * 弃牌建议参数。
+ */
+struct DiscardConfig {
+    int maxDiscard = 3;        // 考虑的最大弃牌张数，弃 4~5 张的抽牌组合多一到两个数量级
+    unsigned threads = 0;      // 0 表示使用硬件并发数
+    long long need = 0;        // 过关还差的分数，> 0 时统计下一手直接过关的概率
+    const std::atomic<bool>* cancel = nullptr;  // 置位后尽快返回，结果不完整且不写入缓存
+};
+
+/**
+ * 单个弃牌方案的期望。
+ */
+struct DiscardEv {
+    std::uint16_t cardMask = 0;   // 第 i 位表示弃第 i 张手牌
+    double expectedScore = 0.0;   // 补牌后最佳出牌得分的期望
+    double clearChance = 0.0;     // 最佳出牌达到 need 的概率；need <= 0 时为 0
+    long long outcomes = 0;       // 枚举的抽牌多重集个数
+};
+
+/**
+ * 弃牌建议。
+ */
+struct DiscardAdvice {
+    std::vector<DiscardEv> options;  // 按期望得分降序
+    double keepScore = 0.0;          // 不弃牌时当前手牌的最佳出牌得分
+    long long evaluations = 0;       // 最佳出牌评估总次数
+    bool complete = true;            // 被取消时为 false
+};
+
+/**
+ * 精确期望弃牌顾问。
+ *
+ * 对每个弃牌子集，枚举从剩余牌中补牌的全部结果，用 HandEvaluator 与 Joker 流水线
+ * 给补牌后的手牌求最佳出牌得分，再按出现概率加权得到期望。
+ * 枚举以多重集而非排列进行：剩余牌按（点数、筹码、花色类）分组，每组取 x 张的方案数为 C(n, x)。
+ * 不被效果引用、且保留牌加补牌也凑不满同花的花色合并为一个花色类——这些花色
+ * 既不参与同花也不触发花色效果，互换后得分不变，因此合并不损失精确性。
+ * 各弃牌子集在工作窃取线程池上并行评估。
+ *
+ * 结果按手牌顺序、剩余牌与 Joker 编队缓存，三者都未变化时直接返回上次结果。
+ * 实例不是线程安全的，同一时刻只能有一个调用方。
+ */
+class DiscardAdvisor {
+public:
+    /**
+     * 计算或取回弃牌建议。
+     *
+     * @param hand 当前手牌
+     * @param deck 剩余牌堆
+     * @param jokers Joker 效果流水线，可为空
+     * @param config 参数
+     * @return 建议，引用在下一次调用前有效
+     */
+    const DiscardAdvice& advise(const std::vector<CardSnapshot>& hand, const Deck& deck,
+                                const EffectPipeline* jokers, const DiscardConfig& config);
+
+    /**
+     * 丢弃缓存。
+     */
+    void invalidate() { m_valid = false; }
+
+private:
+    DiscardAdvice m_advice;
+    std::uint64_t m_key = 0;
+    bool m_valid = false;
+};
@@ -0,0 +1,315 @@
+#include "MctsAdvisor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "../Systems/GameDatabase.hpp"
+#include "SimPolicy.hpp"
+#include "WorkStealing.hpp"
+
+namespace {
+
+struct Node {
+    SimAction action;
+    std::vector<int> children;
+    long long visits = 0;
+    long long availability = 0;  // 该操作在抽样局面中可选的次数
+    double totalReward = 0.0;
+    long long clears = 0;        // 回传时本盲注已过关的次数
+};
+
+bool sameAction(const SimAction& a, const SimAction& b) {
+    return a.kind == b.kind && a.cardMask == b.cardMask;
+}
+
+/**
+ * 追加一个“保留 keepMask、弃掉其余筹码最低者”的弃牌操作。
+ */
+void addDiscard(const RunSimulator& sim, std::uint16_t keepMask, std::vector<SimAction>& out) {
+    const auto& hand = sim.hand();
+    std::array<int, GameStateSnapshot::MAX_HAND> order{};
+    const std::size_t count = std::min(hand.size(), order.size());
+    std::iota(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(count), 0);
+    std::stable_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(count), [&](int a, int b) {
+        return hand[static_cast<std::size_t>(a)].chips < hand[static_cast<std::size_t>(b)].chips;
+    });
+
+    std::uint16_t discardMask = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (std::popcount(discardMask) >= HandEvaluator::MAX_PLAY_CARDS) break;
+        const int index = order[i];
+        if ((keepMask >> index) & 1) continue;
+        discardMask |= static_cast<std::uint16_t>(1u << index);
+    }
+    if (discardMask == 0) return;
+
+    const SimAction action{.kind = SimAction::Kind::Discard, .cardMask = discardMask};
+    for (const auto& existing : out) {
+        if (sameAction(existing, action)) return;
+    }
+    out.push_back(action);
+}
+
+/**
+ * 把快照牌堆转成紧凑牌堆。
+ *
+ * @param db 数据仓库，提供点数筹码表
+ * @param root 根快照
+ * @param out 输出牌堆
+ * @return 含重复牌、无花色牌或筹码与点数表不符（例如增强过的牌）时返回 false
+ */
+bool packDeck(const GameDatabase& db, const GameStateSnapshot& root, PackedDeck& out) {
+    out = PackedDeck(PackedDeck::SnapshotChips([&db](Rank rank) { return db.getRankChips(rank); }));
+    for (const PackedCard card : root.deck) {
+        if (!out.addCard(card.suit(), card.rank())) return false;
+        if (out.cardOf(PackedDeck::IndexOf(card.suit(), card.rank())).baseChips != card.chips) return false;
+    }
+    return true;
+}
+
+/**
+ * 单棵搜索树。
+ */
+class SearchTree {
+public:
+    SearchTree(const GameDatabase& database, const GameStateSnapshot& root, const MctsConfig& config, RngStream rng)
+        : m_sim(database, searchConfig()), m_root(root), m_config(config), m_rng(rng) {
+        m_nodes.emplace_back();
+        m_packedRoot = packDeck(database, root, m_rootDeck);
+    }
+
+    /**
+     * 执行一次迭代：抽样牌序、树内选择与扩展、贪心模拟、回传奖励。
+     */
+    void iterate() {
+        // 玩家看不到牌堆顺序，每次迭代重新洗乱剩余牌得到一个确定化局面。
+        // 能用紧凑牌堆表示时只洗单字节编码，键与张数统计随掩码带入，不必逐张重算。
+        if (m_packedRoot) {
+            m_deck = m_rootDeck;
+            m_deck.shuffle(m_rng);
+            m_sim.restore(m_root, &m_deck);
+        } else {
+            m_scratch = m_root;
+            for (std::size_t i = m_scratch.deck.size(); i > 1; --i) {
+                std::swap(m_scratch.deck[i - 1], m_scratch.deck[m_rng.uniform(i)]);
+            }
+            m_sim.restore(m_scratch);
+        }
+
+        const int roundsBefore = m_sim.roundsCleared();
+        const auto inBlind = [&] {
+            return m_sim.context().state == GameState::Run && m_sim.roundsCleared() == roundsBefore;
+        };
+
+        m_path.clear();
+        m_path.push_back(0);
+        int node = 0;
+        for (int depth = 0; depth < m_config.maxDepth && inBlind(); ++depth) {
+            MctsAdvisor::ListActions(m_sim, m_config.playCandidates, m_actions);
+            if (m_actions.empty()) break;
+
+            const int next = selectOrExpand(node);
+            if (next < 0 || !m_sim.step(m_nodes[static_cast<std::size_t>(next)].action)) break;
+            node = next;
+            m_path.push_back(node);
+            if (m_nodes[static_cast<std::size_t>(node)].visits == 0) break;
+        }
+
+        while (inBlind()) {
+            if (!m_sim.step(SimPolicy::Greedy(m_sim))) break;
+        }
+
+        const double reward = rewardFor(roundsBefore);
+        const bool cleared = m_sim.roundsCleared() > roundsBefore;
+        for (int index : m_path) {
+            Node& n = m_nodes[static_cast<std::size_t>(index)];
+            ++n.visits;
+            n.totalReward += reward;
+            n.clears += cleared ? 1 : 0;
+        }
+    }
+
+    /**
+     * 导出根节点各操作的统计。
+     *
+     * @return 根操作统计
+     */
+    std::vector<MctsChoice> rootChoices() const {
+        std::vector<MctsChoice> choices;
+        for (int child : m_nodes.front().children) {
+            const Node& n = m_nodes[static_cast<std::size_t>(child)];
+            choices.push_back({n.action, n.visits, n.visits > 0 ? n.totalReward / n.visits : 0.0,
+                               n.visits > 0 ? static_cast<double>(n.clears) / n.visits : 0.0});
+        }
+        return choices;
+    }
+
+private:
+    static SimConfig searchConfig() {
+        SimConfig config;
+        config.maxRounds = std::numeric_limits<int>::max();
+        return config;
+    }
+
+    /**
+     * 在当前抽样局面可选的操作中，优先扩展未访问操作，否则按 UCB1 选择。
+     */
+    int selectOrExpand(int parent) {
+        int best = -1;
+        double bestScore = -std::numeric_limits<double>::infinity();
+        for (const SimAction& action : m_actions) {
+            int child = -1;
+            for (int existing : m_nodes[static_cast<std::size_t>(parent)].children) {
+                if (sameAction(m_nodes[static_cast<std::size_t>(existing)].action, action)) {
+                    child = existing;
+                    break;
+                }
+            }
+            if (child < 0) {
+                child = static_cast<int>(m_nodes.size());
+                m_nodes.emplace_back();
+                m_nodes.back().action = action;
+                m_nodes[static_cast<std::size_t>(parent)].children.push_back(child);
+            }
+
+            Node& n = m_nodes[static_cast<std::size_t>(child)];
+            ++n.availability;
+            if (n.visits == 0) {
+                // 未访问操作直接扩展；同层其余操作的可选次数已在上面计入。
+                if (best < 0 || m_nodes[static_cast<std::size_t>(best)].visits > 0) best = child;
+                bestScore = std::numeric_limits<double>::infinity();
+                continue;
+            }
+            const double score = n.totalReward / n.visits
+                + m_config.exploration * std::sqrt(std::log(static_cast<double>(n.availability)) / n.visits);
+            if (score > bestScore) {
+                bestScore = score;
+                best = child;
+            }
+        }
+        return best;
+    }
+
+    double rewardFor(int roundsBefore) const {
+        if (m_sim.roundsCleared() > roundsBefore) return 1.0;
+        const GameContext& ctx = m_sim.context();
+        if (m_root.targetScore <= 0) return 0.0;
+        // 未过关时按进度给部分奖励，始终低于任何过关结果。
+        const double progress = static_cast<double>(ctx.currentScore) / static_cast<double>(m_root.targetScore);
+        return 0.5 * std::clamp(progress, 0.0, 1.0);
+    }
+
+    RunSimulator m_sim;
+    const GameStateSnapshot& m_root;
+    const MctsConfig& m_config;
+    RngStream m_rng;
+
+    std::vector<Node> m_nodes;
+    std::vector<int> m_path;
+    std::vector<SimAction> m_actions;
+    GameStateSnapshot m_scratch;
+    PackedDeck m_rootDeck;
+    PackedDeck m_deck;
+    bool m_packedRoot = false;
+};
+
+} // namespace
+
+void MctsAdvisor::ListActions(const RunSimulator& sim, int playCandidates, std::vector<SimAction>& out) {
+    out.clear();
+    const GameContext& ctx = sim.context();
+    const auto& hand = sim.hand();
+    if (ctx.state != GameState::Run || hand.empty()) return;
+
+    const auto plays = HandEvaluator::EnumerateBestPlays(hand, &sim.effectPipeline(), std::max(playCandidates, 1));
+    if (ctx.handsLeft > 0) {
+        for (const auto& play : plays) {
+            out.push_back({.kind = SimAction::Kind::Play, .cardMask = play.card_mask});
+        }
+    }
+    if (ctx.discardsLeft <= 0) return;
+
+    // 保留前几名出牌，弃掉其余低筹码牌。
+    const std::size_t keepPlays = std::min<std::size_t>(plays.size(), 3);
+    for (std::size_t i = 0; i < keepPlays; ++i) {
+        addDiscard(sim, plays[i].card_mask, out);
+    }
+
+    // 同花方向：保留张数最多的花色。
+    std::array<int, 5> suitCounts{};
+    std::array<int, 15> rankCounts{};
+    for (const auto& card : hand) {
+        ++suitCounts[static_cast<std::size_t>(card.suit)];
+        ++rankCounts[static_cast<std::size_t>(card.rank)];
+    }
+    const auto topSuit = static_cast<Suit>(std::max_element(suitCounts.begin(), suitCounts.end()) - suitCounts.begin());
+
+    std::uint16_t suitKeep = 0;
+    std::uint16_t pairKeep = 0;
+    for (std::size_t i = 0; i < hand.size(); ++i) {
+        const auto bit = static_cast<std::uint16_t>(1u << i);
+        if (hand[i].suit == topSuit) suitKeep |= bit;
+        if (rankCounts[static_cast<std::size_t>(hand[i].rank)] >= 2) pairKeep |= bit;
+    }
+    addDiscard(sim, suitKeep, out);
+    // 成对方向：保留所有成对点数，没有对子时不生成。
+    if (pairKeep != 0) addDiscard(sim, pairKeep, out);
+}
+
+MctsDecision MctsAdvisor::Decide(const GameDatabase& database, const GameStateSnapshot& root, const MctsConfig& config) {
+    MctsDecision decision;
+    if (root.state != GameState::Run || root.hand.empty()) return decision;
+    if (config.timeBudgetMs <= 0 && config.maxIterations <= 0) return decision;
+
+    unsigned trees = config.threads != 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::vector<MctsChoice>> perTree(trees);
+    std::vector<long long> iterations(trees, 0);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.timeBudgetMs);
+    const RngStream base(config.seed, 0);
+
+    WorkStealing::ParallelFor(trees, trees, [&](std::size_t tree, unsigned) {
+        SearchTree search(database, root, config, base.fork(tree));
+        long long done = 0;
+        while (config.maxIterations <= 0 || done < config.maxIterations) {
+            if (config.cancel && config.cancel->load(std::memory_order_relaxed)) break;
+            // 每 32 次迭代看一次时钟，避免计时本身成为开销。
+            if (config.timeBudgetMs > 0 && (done & 31) == 0 && std::chrono::steady_clock::now() >= deadline) break;
+            search.iterate();
+            ++done;
+        }
+        iterations[tree] = done;
+        perTree[tree] = search.rootChoices();
+    });
+
+    // 合并各树的根统计：访问数直接相加，平均奖励与过关率按访问数加权。
+    for (std::size_t tree = 0; tree < trees; ++tree) {
+        decision.iterations += iterations[tree];
+        for (const auto& choice : perTree[tree]) {
+            auto it = std::find_if(decision.choices.begin(), decision.choices.end(), [&](const MctsChoice& c) {
+                return sameAction(c.action, choice.action);
+            });
+            if (it == decision.choices.end()) {
+                decision.choices.push_back(choice);
+                continue;
+            }
+            const long long visits = it->visits + choice.visits;
+            if (visits > 0) {
+                it->meanReward = (it->meanReward * it->visits + choice.meanReward * choice.visits) / visits;
+                it->clearRate = (it->clearRate * it->visits + choice.clearRate * choice.visits) / visits;
+            }
+            it->visits = visits;
+        }
+    }
+
+    std::stable_sort(decision.choices.begin(), decision.choices.end(), [](const MctsChoice& a, const MctsChoice& b) {
+        return a.visits > b.visits;
+    });
+    if (!decision.choices.empty()) decision.action = decision.choices.front().action;
+    return decision;
+}
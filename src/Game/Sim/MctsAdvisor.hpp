@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "../Core/GameStateSnapshot.hpp"
+#include "RunSimulator.hpp"
+
+class GameDatabase;
+
+/**
+ * 搜索参数。
+ */
+struct MctsConfig {
+    int timeBudgetMs = 250;        // 墙钟预算，<= 0 表示只受迭代数限制
+    long long maxIterations = 0;   // 每棵树的迭代上限，0 表示只受时间限制
+    unsigned threads = 0;          // 根并行的树数，0 表示使用硬件并发数
+    std::uint64_t seed = 1;        // 抽样未知牌序所用种子
+    double exploration = 0.7;      // UCB1 探索系数，奖励位于 [0, 1]
+    int maxDepth = 4;              // 树内最多展开的操作数，更深处交给贪心模拟
+    int playCandidates = 6;        // 每个节点考虑的最优出牌数
+    const std::atomic<bool>* cancel = nullptr;  // 置位后各树在当前迭代结束即返回
+};
+
+/**
+ * 根节点上一个候选操作的统计。
+ */
+struct MctsChoice {
+    SimAction action;
+    long long visits = 0;
+    double meanReward = 0.0;   // 含未过关时的部分奖励，不是概率
+    double clearRate = 0.0;    // 模拟中本盲注过关的比例
+};
+
+/**
+ * 搜索结果。
+ */
+struct MctsDecision {
+    SimAction action;                  // 访问次数最多的根操作
+    std::vector<MctsChoice> choices;   // 全部根操作，按访问次数降序
+    long long iterations = 0;          // 所有树的迭代总数
+};
+
+namespace MctsAdvisor {
+
+/**
+ * 列出局面下搜索考虑的出牌与弃牌操作。
+ *
+ * 出牌取得分最高的若干组合；弃牌为“保留某个高分出牌、弃掉其余低筹码牌”
+ * 以及“保留最多的花色”“保留成对点数”三类追牌方向，均不超过 5 张。
+ *
+ * @param sim 处于盲注中的模拟器
+ * @param playCandidates 出牌候选数
+ * @param out 输出操作，先清空
+ */
+void ListActions(const RunSimulator& sim, int playCandidates, std::vector<SimAction>& out);
+
+/**
+ * 为当前盲注选择出牌或弃牌。
+ *
+ * 信息集蒙特卡洛树搜索：每次迭代先用独立随机流重新洗乱剩余牌堆，
+ * 把玩家看不到的牌序抽样成一个确定局面，再沿树按 UCB1 选择操作，
+ * 超出树深后用贪心策略模拟到本盲注结束。过关奖励为 1，
+ * 未过关按得分占目标比例给部分奖励。
+ * 各线程各自建树（根并行），结束后合并根节点统计。
+ *
+ * @param database 数据仓库，搜索期间只读
+ * @param root 盲注中的局面
+ * @param config 搜索参数
+ * @return 搜索结果；局面不在盲注中或无可行操作时 choices 为空
+ */
+MctsDecision Decide(const GameDatabase& database, const GameStateSnapshot& root, const MctsConfig& config);
+
+} // namespace MctsAdvisor
@@ -0,0 +1,55 @@
+#include "ReplayRunner.hpp"
+
+#include <bit>
+#include <limits>
+
+SimConfig ReplayRunner::ConfigFor(const Replay& replay) {
+    SimConfig config;
+    config.seed = replay.seed;
+    config.maxRounds = std::numeric_limits<int>::max();
+    return config;
+}
+
+bool ReplayRunner::Apply(RunSimulator& sim, const ReplayAction& action, std::uint16_t& selection) {
+    switch (action.op) {
+        case ReplayOp::Select:
+            if (sim.context().state != GameState::Run ||
+                std::popcount(action.mask) > HandEvaluator::MAX_PLAY_CARDS ||
+                (action.mask >> sim.hand().size()) != 0) {
+                return false;
+            }
+            selection = action.mask;
+            return true;
+        case ReplayOp::Play:
+        case ReplayOp::Discard: {
+            const auto kind = action.op == ReplayOp::Play ? SimAction::Kind::Play : SimAction::Kind::Discard;
+            if (!sim.step({.kind = kind, .cardMask = selection})) return false;
+            selection = 0;
+            return true;
+        }
+        case ReplayOp::Buy:
+            return sim.step({.kind = SimAction::Kind::Buy, .shopIndex = action.shopIndex});
+        case ReplayOp::Replace:
+            return sim.step({
+                .kind = SimAction::Kind::Buy,
+                .shopIndex = action.shopIndex,
+                .replaceIndex = action.jokerIndex,
+            });
+        case ReplayOp::Reroll:
+            return sim.step({.kind = SimAction::Kind::Reroll});
+        case ReplayOp::NextRound:
+            selection = 0;
+            return sim.step({.kind = SimAction::Kind::NextRound});
+    }
+    return false;
+}
+
+std::size_t ReplayRunner::Run(RunSimulator& sim, const Replay& replay) {
+    std::uint16_t selection = 0;
+    std::size_t applied = 0;
+    for (const auto& action : replay.actions) {
+        if (!Apply(sim, action, selection)) break;
+        ++applied;
+    }
+    return applied;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+#include "../Systems/Replay.hpp"
+#include "RunSimulator.hpp"
+
+namespace ReplayRunner {
+
+/**
+ * 为录像构造与图形客户端一致的模拟参数。
+ *
+ * 客户端没有胜利轮数上限，回放时同样不设上限。
+ *
+ * @param replay 录像
+ * @return 模拟参数
+ */
+SimConfig ConfigFor(const Replay& replay);
+
+/**
+ * 执行一条录像操作。
+ *
+ * Select 只更新选中掩码，Play/Discard 作用于当前掩码后清空，
+ * 与客户端“打出/弃掉后选中牌离开手牌”的行为一致。
+ *
+ * @param sim 模拟器
+ * @param action 录像操作
+ * @param selection 当前选中掩码，跨调用保持
+ * @return 是否执行成功；失败说明录像与规则已不一致
+ */
+bool Apply(RunSimulator& sim, const ReplayAction& action, std::uint16_t& selection);
+
+/**
+ * 无界面全速回放整份录像。
+ *
+ * @param sim 以 ConfigFor(replay) 构造的模拟器
+ * @param replay 录像
+ * @return 成功执行的操作数；小于操作总数表示在该下标处失败
+ */
+std::size_t Run(RunSimulator& sim, const Replay& replay);
+
+} // namespace ReplayRunner
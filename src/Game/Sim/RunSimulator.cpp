@@ -0,0 +1,284 @@
+#include "RunSimulator.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "../Systems/GameDatabase.hpp"
+#include "../Systems/RunFlow.hpp"
+#include "../Systems/ScoringManager.hpp"
+#include "../Systems/ShopFlow.hpp"
+#include "../Systems/ShopRestock.hpp"
+
+RunSimulator::RunSimulator(const GameDatabase& database, const SimConfig& config)
+    : m_db(database), m_config(config) {
+    m_ctx.rng.reseed(config.seed);
+    m_ctx.deck.setRankChipProvider([db = &m_db](Rank rank) { return db->getRankChips(rank); });
+    m_deckTemplate = PackedDeck(PackedDeck::SnapshotChips([db = &m_db](Rank rank) { return db->getRankChips(rank); }));
+
+    // 数据库按哈希表存储，排序后商品池顺序才与种子一一对应。
+    m_jokerPool = m_db.getAllJokerIds();
+    std::sort(m_jokerPool.begin(), m_jokerPool.end());
+
+    startRound();
+}
+
+bool RunSimulator::step(const SimAction& action) {
+    switch (action.kind) {
+        case SimAction::Kind::Play:      return play(action.cardMask);
+        case SimAction::Kind::Discard:   return discard(action.cardMask);
+        case SimAction::Kind::Buy:       return buy(action.shopIndex, action.replaceIndex);
+        case SimAction::Kind::Reroll:    return reroll();
+        case SimAction::Kind::NextRound:
+            if (m_ctx.state != GameState::Shop) return false;
+            startRound();
+            return true;
+    }
+    return false;
+}
+
+bool RunSimulator::play(std::uint16_t cardMask) {
+    if (m_ctx.state != GameState::Run || m_ctx.handsLeft <= 0 || !isValidSelection(cardMask)) {
+        return false;
+    }
+
+    m_selected.clear();
+    m_held.clear();
+    for (std::size_t i = 0; i < m_hand.size(); ++i) {
+        ((cardMask >> i) & 1 ? m_selected : m_held).push_back(m_hand[i]);
+    }
+
+    // 与 RunState::playHand 顺序一致：评估、计分、移除补牌，最后判定迁移。
+    const HandResult handRes = HandEvaluator::Evaluate(m_selected);
+    const ScoreSummary summary = ScoringManager::CalculateFinalScore(
+        handRes.base_chips,
+        handRes.base_mult,
+        handRes.scoring_snapshots,
+        m_held,
+        &m_effects
+    );
+    ++m_handTypeCounts[static_cast<std::size_t>(handRes.type)];
+
+    removeCards(cardMask);
+    refillHand();
+
+    const RoundTransition transition = RunFlow::ApplyPlay(m_ctx, summary);
+    if (transition == RoundTransition::ToShop) {
+        ++m_roundsCleared;
+        if (m_roundsCleared >= m_config.maxRounds) {
+            m_ctx.state = GameState::Victory;
+        } else {
+            m_ctx.state = GameState::Shop;
+            restockShop();
+        }
+    } else if (transition == RoundTransition::GameOver) {
+        m_ctx.state = GameState::GameOver;
+    }
+    return true;
+}
+
+bool RunSimulator::discard(std::uint16_t cardMask) {
+    if (m_ctx.state != GameState::Run || m_ctx.discardsLeft <= 0 || !isValidSelection(cardMask)) {
+        return false;
+    }
+
+    m_selected.clear();
+    for (std::size_t i = 0; i < m_hand.size(); ++i) {
+        if ((cardMask >> i) & 1) m_selected.push_back(m_hand[i]);
+    }
+
+    const ScoreSummary discardSummary = ScoringManager::CalculateDiscardEffect(m_selected, &m_effects);
+    RunFlow::ApplyDiscard(m_ctx, discardSummary);
+    removeCards(cardMask);
+    refillHand();
+    return true;
+}
+
+bool RunSimulator::buy(int shopIndex, int replaceIndex) {
+    if (m_ctx.state != GameState::Shop ||
+        shopIndex < 0 || shopIndex >= static_cast<int>(m_offers.size())) {
+        return false;
+    }
+
+    const SimOffer& offer = m_offers[static_cast<std::size_t>(shopIndex)];
+    const auto decision = ShopFlow::EvaluatePurchase(m_ctx, offer.cost, static_cast<int>(m_jokers.size()));
+    if (!decision.affordable) return false;
+    if (decision.requiresReplace &&
+        (replaceIndex < 0 || replaceIndex >= static_cast<int>(m_jokers.size()))) {
+        return false;
+    }
+
+    auto effect = m_db.createJokerEffect(offer.id);
+    if (!effect || !ShopFlow::TrySpend(m_ctx, offer.cost)) return false;
+
+    // 与 ShopState 一致：替换时移走旧牌，新牌追加到编队末尾。
+    if (decision.requiresReplace) {
+        m_jokers.erase(m_jokers.begin() + replaceIndex);
+    }
+    m_jokers.push_back(SimJoker{offer.id, std::move(effect), offer.poolIndex});
+    m_offers.erase(m_offers.begin() + shopIndex);
+    rekeyOffers();
+    rebuildEffects();
+    return true;
+}
+
+bool RunSimulator::reroll() {
+    if (m_ctx.state != GameState::Shop || !ShopFlow::TryReroll(m_ctx)) return false;
+    restockShop();
+    return true;
+}
+
+bool RunSimulator::isValidSelection(std::uint16_t cardMask) const {
+    const int count = std::popcount(cardMask);
+    return count > 0 && count <= HandEvaluator::MAX_PLAY_CARDS && (cardMask >> m_hand.size()) == 0;
+}
+
+void RunSimulator::removeCards(std::uint16_t cardMask) {
+    std::size_t write = 0;
+    for (std::size_t i = 0; i < m_hand.size(); ++i) {
+        if (!((cardMask >> i) & 1)) {
+            m_hand[write++] = m_hand[i];
+        } else {
+            m_handKey -= Zobrist::Card(m_hand[i].suit, m_hand[i].rank);
+        }
+    }
+    m_hand.resize(write);
+}
+
+void RunSimulator::startRound() {
+    // 与 RunState::onEnter 一致：重置回合资源、重建牌堆并补满手牌。
+    m_ctx.state = GameState::Run;
+    m_ctx.currentScore = 0;
+    m_ctx.handsLeft = m_config.handsPerRound;
+    m_ctx.discardsLeft = m_config.discardsPerRound;
+    if (m_ctx.targetScore == 0) m_ctx.targetScore = 300;
+
+    m_offers.clear();
+    m_offerKey = 0;
+    m_hand.clear();
+    m_handKey = 0;
+    // 在紧凑牌堆上重建并洗牌再导出，随机数消耗与 Deck::shuffle 相同。
+    m_deckTemplate.initStandardDeck();
+    m_deckTemplate.shuffle(m_ctx.rng.stream(RngStreamId::Deck));
+    m_deckTemplate.exportTo(m_ctx.deck);
+    refillHand();
+}
+
+void RunSimulator::refillHand() {
+    while (static_cast<int>(m_hand.size()) < GameContext::HAND_SIZE_LIMIT) {
+        auto cardData = m_ctx.deck.draw();
+        if (!cardData) break;
+        m_hand.push_back(CardSnapshot{
+            .suit = cardData->suit,
+            .rank = cardData->rank,
+            .chips = cardData->baseChips,
+        });
+        m_handKey += Zobrist::Card(cardData->suit, cardData->rank);
+    }
+}
+
+void RunSimulator::restockShop() {
+    m_offers.clear();
+    const auto picked = ShopRestock::PickIds(
+        m_jokerPool,
+        m_config.shopSize,
+        m_ctx.rng.stream(RngStreamId::Shop)
+    );
+    for (const auto& id : picked) {
+        const JokerData* data = m_db.findJoker(id);
+        if (!data) continue;
+        m_offers.push_back({id, data->cost, poolIndexOf(id)});
+    }
+    rekeyOffers();
+}
+
+void RunSimulator::rebuildEffects() {
+    m_effects.clear();
+    m_jokerKey = 0;
+    for (std::size_t i = 0; i < m_jokers.size(); ++i) {
+        m_effects.add(m_jokers[i].effect.get());
+        m_jokerKey += Zobrist::Joker(m_jokers[i].poolIndex, i);
+    }
+}
+
+void RunSimulator::rekeyOffers() {
+    // 购买会让后续商品前移，按位置重算；商店最多几件商品，开销可忽略。
+    m_offerKey = 0;
+    for (std::size_t i = 0; i < m_offers.size(); ++i) {
+        m_offerKey += Zobrist::Offer(m_offers[i].poolIndex, i, m_offers[i].cost);
+    }
+}
+
+std::uint64_t RunSimulator::zobrist() const {
+    return GameStateSnapshot::ComposeZobrist(m_ctx.deck.zobrist(), m_handKey, m_jokerKey, m_offerKey) ^
+           GameStateSnapshot::CounterKey(m_ctx.state, m_ctx.handsLeft, m_ctx.discardsLeft, m_ctx.money,
+                                         m_ctx.currentScore, m_ctx.targetScore, m_roundsCleared);
+}
+
+std::uint8_t RunSimulator::poolIndexOf(const std::string& id) const {
+    const auto it = std::lower_bound(m_jokerPool.begin(), m_jokerPool.end(), id);
+    return static_cast<std::uint8_t>(it - m_jokerPool.begin());
+}
+
+bool RunSimulator::capture(GameStateSnapshot& out) const {
+    if (!out.captureContext(m_ctx)) return false;
+    out.roundsCleared = m_roundsCleared;
+    std::copy(m_handTypeCounts.begin(), m_handTypeCounts.end(), out.handTypeCounts.begin());
+
+    out.hand.clear();
+    for (const auto& card : m_hand) {
+        if (!out.hand.push_back(GameStateSnapshot::Pack(card))) return false;
+    }
+    out.jokers.clear();
+    for (const auto& joker : m_jokers) out.jokers.push_back(joker.poolIndex);
+    out.offers.clear();
+    for (const auto& offer : m_offers) {
+        out.offers.push_back({offer.poolIndex, static_cast<std::int16_t>(offer.cost)});
+    }
+    return true;
+}
+
+bool RunSimulator::restore(const GameStateSnapshot& snapshot, const PackedDeck* deck) {
+    for (std::uint8_t index : snapshot.jokers) {
+        if (index >= m_jokerPool.size()) return false;
+    }
+    for (const auto& offer : snapshot.offers) {
+        if (offer.joker >= m_jokerPool.size()) return false;
+    }
+
+    if (deck) {
+        snapshot.restoreCounters(m_ctx);
+        deck->exportTo(m_ctx.deck);
+    } else {
+        snapshot.restoreContext(m_ctx);
+    }
+    m_roundsCleared = snapshot.roundsCleared;
+    std::copy(snapshot.handTypeCounts.begin(), snapshot.handTypeCounts.end(), m_handTypeCounts.begin());
+
+    m_hand.clear();
+    m_handKey = 0;
+    for (const PackedCard card : snapshot.hand) {
+        m_hand.push_back(GameStateSnapshot::Unpack(card));
+        m_handKey += Zobrist::Card(card.suit(), card.rank());
+    }
+
+    m_offers.clear();
+    for (const auto& offer : snapshot.offers) {
+        m_offers.push_back({m_jokerPool[offer.joker], offer.cost, offer.joker});
+    }
+    rekeyOffers();
+
+    const bool sameJokers = std::equal(
+        m_jokers.begin(), m_jokers.end(),
+        snapshot.jokers.begin(), snapshot.jokers.end(),
+        [](const SimJoker& joker, std::uint8_t index) { return joker.poolIndex == index; }
+    );
+    if (!sameJokers) {
+        m_jokers.clear();
+        for (std::uint8_t index : snapshot.jokers) {
+            const std::string& id = m_jokerPool[index];
+            m_jokers.push_back(SimJoker{id, m_db.createJokerEffect(id), index});
+        }
+        rebuildEffects();
+    }
+    return true;
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Core/GameContext.hpp"
+#include "../Core/GameStateSnapshot.hpp"
+#include "../Core/PackedDeck.hpp"
+#include "../Effects/EffectPipeline.hpp"
+#include "../Systems/CardSnapshot.hpp"
+#include "../Systems/HandEvaluator.hpp"
+
+class GameDatabase;
+
+/**
+ * 无界面模拟的单步操作。
+ */
+struct SimAction {
+    enum class Kind : std::uint8_t {
+        Play,       // 出 cardMask 指定的手牌
+        Discard,    // 弃 cardMask 指定的手牌
+        Buy,        // 购买 shopIndex 商品，满槽时替换 replaceIndex
+        Reroll,     // 刷新商店
+        NextRound   // 离开商店进入下一盲注
+    };
+
+    Kind kind = Kind::NextRound;
+    std::uint16_t cardMask = 0;  // 第 i 位表示手牌第 i 张
+    int shopIndex = -1;
+    int replaceIndex = -1;
+};
+
+/**
+ * 模拟参数。
+ */
+struct SimConfig {
+    std::uint64_t seed = 0;
+    int maxRounds = 24;        // 连续过关达到该数即判定胜利
+    int handsPerRound = 4;
+    int discardsPerRound = 3;
+    int shopSize = 3;
+};
+
+/**
+ * 无界面编队中的 Joker。
+ */
+struct SimJoker {
+    std::string id;
+    std::shared_ptr<IEffect> effect;
+    std::uint8_t poolIndex = 0;  // 在排序 Joker ID 池中的下标
+};
+
+/**
+ * 商店商品。
+ */
+struct SimOffer {
+    std::string id;
+    int cost = 0;
+    std::uint8_t poolIndex = 0;
+};
+
+/**
+ * 无界面整局模拟器。
+ *
+ * 以“盲注 → 商店 → 盲注”的完整流程推进一局游戏，规则全部复用
+ * HandEvaluator、ScoringManager、RunFlow、ShopFlow 与 ShopRestock，
+ * 与图形客户端共享同一套判定，但不创建任何卡牌渲染对象。
+ * 阶段沿用 GameContext::state：Run 为盲注中，Shop 为商店中，
+ * GameOver/Victory 为终局。
+ * 随机数来自 GameContext::rng 的命名流，同一种子与操作序列得到同一局面。
+ */
+class RunSimulator {
+public:
+    // 每个底注包含小盲、大盲与 Boss 盲三场盲注。
+    static constexpr int BLINDS_PER_ANTE = 3;
+
+    /**
+     * 开始新的一局。
+     *
+     * @param database 已加载的数据仓库，需在模拟期间保持有效
+     * @param config 模拟参数
+     */
+    RunSimulator(const GameDatabase& database, const SimConfig& config);
+
+    /**
+     * 执行一步操作。
+     *
+     * 非法操作（阶段不符、下标越界、资源不足等）不改变状态。
+     *
+     * @param action 操作
+     * @return 是否执行成功
+     */
+    bool step(const SimAction& action);
+
+    /**
+     * 判断本局是否结束。
+     *
+     * @return 是否已失败或胜利
+     */
+    bool finished() const {
+        return m_ctx.state == GameState::GameOver || m_ctx.state == GameState::Victory;
+    }
+
+    /**
+     * 导出当前局面。
+     *
+     * @param out 输出快照
+     * @return 牌堆或手牌超出快照容量时返回 false，此时快照不完整
+     */
+    [[nodiscard]] bool capture(GameStateSnapshot& out) const;
+
+    /**
+     * 恢复到快照局面。
+     *
+     * Joker 编队与当前一致时复用已有效果对象，树搜索反复回退到同一节点时不分配内存。
+     *
+     * @param snapshot 快照
+     * @param deck 非空时牌堆取自该对象而非快照，供搜索确定化时直接传入重新洗过的牌堆
+     * @return 快照引用了不存在的 Joker 时返回 false
+     */
+    bool restore(const GameStateSnapshot& snapshot, const PackedDeck* deck = nullptr);
+
+    /**
+     * 获取当前局面的 Zobrist 键。
+     *
+     * 牌堆、手牌、Joker 与商品的多重集键随操作增量维护，计数器键按当前值合成，
+     * 结果与 capture 所得快照的 GameStateSnapshot::zobrist 相同。
+     *
+     * @return 局面键
+     */
+    std::uint64_t zobrist() const;
+
+    const GameContext& context() const { return m_ctx; }
+    const std::vector<CardSnapshot>& hand() const { return m_hand; }
+    const std::vector<SimJoker>& jokers() const { return m_jokers; }
+    const std::vector<SimOffer>& offers() const { return m_offers; }
+    const EffectPipeline& effectPipeline() const { return m_effects; }
+    const SimConfig& config() const { return m_config; }
+
+    /**
+     * 获取已通过的盲注数。
+     *
+     * @return 过关数
+     */
+    int roundsCleared() const { return m_roundsCleared; }
+
+    /**
+     * 获取当前所处底注。
+     *
+     * @return 底注编号，从 1 开始
+     */
+    int ante() const { return 1 + m_roundsCleared / BLINDS_PER_ANTE; }
+
+    /**
+     * 获取各牌型的出牌次数。
+     *
+     * @return 以 PokerHandType 为下标的计数
+     */
+    const std::array<int, 13>& handTypeCounts() const { return m_handTypeCounts; }
+
+private:
+    bool play(std::uint16_t cardMask);
+    bool discard(std::uint16_t cardMask);
+    bool buy(int shopIndex, int replaceIndex);
+    bool reroll();
+
+    bool isValidSelection(std::uint16_t cardMask) const;
+    void removeCards(std::uint16_t cardMask);
+    void startRound();
+    void refillHand();
+    void restockShop();
+    void rebuildEffects();
+    void rekeyOffers();
+    std::uint8_t poolIndexOf(const std::string& id) const;
+
+    const GameDatabase& m_db;
+    SimConfig m_config;
+    GameContext m_ctx;
+
+    std::vector<CardSnapshot> m_hand;
+    std::vector<SimJoker> m_jokers;
+    std::vector<SimOffer> m_offers;
+    std::vector<std::string> m_jokerPool;
+    EffectPipeline m_effects;
+
+    // 出牌时的计分与手持牌缓冲，跨出牌复用容量。
+    std::vector<CardSnapshot> m_selected;
+    std::vector<CardSnapshot> m_held;
+
+    // 开局重建牌堆用的紧凑牌堆，筹码表在构造时从数据库拍下。
+    PackedDeck m_deckTemplate;
+
+    int m_roundsCleared = 0;
+    std::array<int, 13> m_handTypeCounts{};
+
+    // 手牌、Joker 与商品的多重集 Zobrist 键。
+    std::uint64_t m_handKey = 0;
+    std::uint64_t m_jokerKey = 0;
+    std::uint64_t m_offerKey = 0;
+};
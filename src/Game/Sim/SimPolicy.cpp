@@ -0,0 +1,70 @@
+#include "SimPolicy.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+#include "../Systems/ShopFlow.hpp"
+
+namespace {
+
+SimAction chooseBlindAction(const RunSimulator& sim) {
+    const GameContext& ctx = sim.context();
+    const auto& hand = sim.hand();
+    const auto best = HandEvaluator::EnumerateBestPlays(hand, &sim.effectPipeline(), 1);
+    if (best.empty()) return {.kind = SimAction::Kind::Play, .cardMask = 1};
+
+    const PlayCandidate& play = best.front();
+    const long long remaining = ctx.targetScore - ctx.currentScore;
+    const bool onPace = play.final_score * ctx.handsLeft >= remaining;
+    if (onPace || ctx.discardsLeft <= 0) {
+        return {.kind = SimAction::Kind::Play, .cardMask = play.card_mask};
+    }
+
+    // 保留最优出牌，其余按筹码从低到高弃掉，最多弃 MAX_PLAY_CARDS 张。
+    std::vector<int> order(hand.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return hand[static_cast<std::size_t>(a)].chips < hand[static_cast<std::size_t>(b)].chips;
+    });
+
+    std::uint16_t discardMask = 0;
+    for (int i : order) {
+        if (std::popcount(discardMask) >= HandEvaluator::MAX_PLAY_CARDS) break;
+        if ((play.card_mask >> i) & 1) continue;
+        discardMask |= static_cast<std::uint16_t>(1u << i);
+    }
+    if (discardMask == 0) {
+        return {.kind = SimAction::Kind::Play, .cardMask = play.card_mask};
+    }
+    return {.kind = SimAction::Kind::Discard, .cardMask = discardMask};
+}
+
+SimAction chooseShopAction(const RunSimulator& sim) {
+    const auto& offers = sim.offers();
+    const int owned = static_cast<int>(sim.jokers().size());
+    for (std::size_t i = 0; i < offers.size(); ++i) {
+        const auto decision = ShopFlow::EvaluatePurchase(sim.context(), offers[i].cost, owned);
+        if (decision.affordable && !decision.requiresReplace) {
+            return {.kind = SimAction::Kind::Buy, .shopIndex = static_cast<int>(i)};
+        }
+    }
+    return {.kind = SimAction::Kind::NextRound};
+}
+
+} // namespace
+
+SimAction SimPolicy::Greedy(const RunSimulator& sim) {
+    if (sim.context().state == GameState::Shop) return chooseShopAction(sim);
+    return chooseBlindAction(sim);
+}
+
+long long SimPolicy::PlayOutGreedy(RunSimulator& sim) {
+    long long steps = 0;
+    while (!sim.finished()) {
+        // 策略只会给出合法操作；防御性检查避免异常策略陷入死循环。
+        if (!sim.step(Greedy(sim))) return -1;
+        ++steps;
+    }
+    return steps;
+}
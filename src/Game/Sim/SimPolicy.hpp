@@ -0,0 +1,27 @@
+#pragma once
+
+#include "RunSimulator.hpp"
+
+namespace SimPolicy {
+
+/**
+ * 贪心策略。
+ *
+ * 盲注中出当前得分最高的牌；若剩余手数按该得分无法达标且还有弃牌次数，
+ * 则弃掉最优出牌之外筹码最低的牌。商店中购买第一件买得起且有空槽的商品，
+ * 否则进入下一盲注。策略只读模拟器状态，相同状态总是给出相同操作。
+ *
+ * @param sim 模拟器
+ * @return 下一步操作
+ */
+SimAction Greedy(const RunSimulator& sim);
+
+/**
+ * 用贪心策略把一局推进到结束。
+ *
+ * @param sim 模拟器
+ * @return 本局执行的步数；策略给出非法操作时返回 -1
+ */
+long long PlayOutGreedy(RunSimulator& sim);
+
+} // namespace SimPolicy
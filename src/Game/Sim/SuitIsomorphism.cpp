@@ -0,0 +1,90 @@
+#include "SuitIsomorphism.hpp"
+
+#include <algorithm>
+
+namespace {
+
+using SuitMask = SuitIsomorphism::SuitMask;
+
+// 每个花色的签名：前 13 字节为手牌中各点数张数，后 13 字节为剩余牌中各点数张数。
+constexpr std::size_t RANK_COUNT = 13;
+using Signature = std::array<std::uint8_t, RANK_COUNT * 2>;
+
+SuitMask suitBit(Suit suit) {
+    const auto index = static_cast<unsigned>(suit);
+    return index < SuitIsomorphism::SUIT_COUNT ? static_cast<SuitMask>(1u << index) : 0;
+}
+
+void countCards(std::span<const PackedCard> cards, std::size_t offset,
+                std::array<Signature, SuitIsomorphism::SUIT_COUNT>& signatures) {
+    for (const PackedCard card : cards) {
+        const auto suit = static_cast<std::size_t>(card.suit());
+        if (suit >= signatures.size()) continue;
+        const auto rank = static_cast<std::size_t>(card.rank()) - static_cast<std::size_t>(Rank::Two);
+        if (rank >= RANK_COUNT) continue;
+        std::uint8_t& count = signatures[suit][offset + rank];
+        if (count < 0xFF) ++count;
+    }
+}
+
+} // namespace
+
+SuitMask SuitIsomorphism::PinnedSuits(const EffectPipeline& pipeline) {
+    SuitMask pinned = 0;
+    for (int t = 0; t < TRIGGER_TYPE_COUNT; ++t) {
+        for (const EffectBinding& binding : pipeline.forTrigger(static_cast<TriggerType>(t))) {
+            if (!binding.builtin) return ALL_SUITS;
+            const BuiltinEffect& spec = binding.spec;
+            if (spec.kind == BuiltinEffectKind::SuitMult) {
+                pinned |= suitBit(spec.suit);
+            } else if (spec.kind == BuiltinEffectKind::Script && spec.program) {
+                for (const JokerOp& op : spec.program->ops) {
+                    if (op.code == JokerOpCode::RequireSuit) pinned |= suitBit(static_cast<Suit>(op.value));
+                }
+            }
+        }
+    }
+    return pinned;
+}
+
+SuitIsomorphism::SuitMap SuitIsomorphism::Canonicalize(std::span<const PackedCard> hand,
+                                                       std::span<const PackedCard> deck,
+                                                       SuitMask pinned) {
+    std::array<Signature, SUIT_COUNT> signatures{};
+    countCards(hand, 0, signatures);
+    countCards(deck, RANK_COUNT, signatures);
+
+    std::array<int, SUIT_COUNT> freeSuits{};
+    int freeCount = 0;
+    for (int s = 0; s < SUIT_COUNT; ++s) {
+        if (!(pinned & (1u << s))) freeSuits[static_cast<std::size_t>(freeCount++)] = s;
+    }
+
+    // freeSuits 升序即目标标记；按签名降序排出的第 i 个花色映射到第 i 个标记。
+    std::array<int, SUIT_COUNT> order = freeSuits;
+    std::stable_sort(order.begin(), order.begin() + freeCount, [&](int a, int b) {
+        return signatures[static_cast<std::size_t>(a)] > signatures[static_cast<std::size_t>(b)];
+    });
+
+    SuitMap map;
+    for (int i = 0; i < freeCount; ++i) {
+        map.to[static_cast<std::size_t>(order[static_cast<std::size_t>(i)])] =
+            static_cast<Suit>(freeSuits[static_cast<std::size_t>(i)]);
+    }
+    return map;
+}
+
+void SuitIsomorphism::Apply(const SuitMap& map, GameStateSnapshot& state) {
+    if (map.isIdentity()) return;
+    const auto relabel = [&](PackedCard& card) { card = PackedCard::Pack(map(card.suit()), card.rank(), card.chips); };
+    for (PackedCard& card : state.hand) relabel(card);
+    for (PackedCard& card : state.deck) relabel(card);
+}
+
+std::uint64_t SuitIsomorphism::CanonicalZobrist(const GameStateSnapshot& state, SuitMask pinned) {
+    const SuitMap map = Canonicalize(state.hand, state.deck, pinned);
+    if (map.isIdentity()) return state.zobrist();
+    GameStateSnapshot canonical = state;
+    Apply(map, canonical);
+    return canonical.zobrist();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "../Core/GameStateSnapshot.hpp"
+#include "../Effects/EffectPipeline.hpp"
+
+/**
+ * 花色同构规约。
+ *
+ * 牌型判定只关心“是否同花色”，多数 Joker 也与具体花色无关，
+ * 因此只差一个花色置换的局面在规则上等价。把局面映射到唯一的代表
+ * （规范花色标记）后，以局面为键的缓存与搜索表最多可缩小 4! = 24 倍。
+ * 被花色相关效果（SuitMult、脚本中的 RequireSuit）引用的花色视为固定，不参与置换。
+ */
+namespace SuitIsomorphism {
+
+constexpr int SUIT_COUNT = 4;
+
+// 第 i 位表示 static_cast<Suit>(i)。
+using SuitMask = std::uint8_t;
+constexpr SuitMask ALL_SUITS = 0x0F;
+
+/**
+ * 花色置换，to[i] 为花色 i 的新标记。
+ */
+struct SuitMap {
+    std::array<Suit, SUIT_COUNT> to{Suit::Spades, Suit::Hearts, Suit::Clubs, Suit::Diamonds};
+
+    Suit operator()(Suit suit) const {
+        const auto index = static_cast<std::size_t>(suit);
+        return index < to.size() ? to[index] : suit;
+    }
+
+    bool isIdentity() const {
+        for (std::size_t i = 0; i < to.size(); ++i) {
+            if (to[i] != static_cast<Suit>(i)) return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * 收集编队中被效果固定的花色。
+ *
+ * 自定义（非内置）效果无法静态分析，出现时固定全部花色，规约退化为恒等。
+ *
+ * @param pipeline 效果流水线
+ * @return 固定花色集合
+ */
+SuitMask PinnedSuits(const EffectPipeline& pipeline);
+
+/**
+ * 求局面的规范花色置换。
+ *
+ * 每个自由花色以“手牌各点数张数、剩余牌各点数张数”为签名，
+ * 按签名降序依次分配到自由花色的标记上；签名相同的花色互换后局面不变，
+ * 因此同构的局面总得到同一个规范代表。固定花色映射到自身。
+ * 剩余牌按多重集比较，不考虑牌序。
+ *
+ * @param hand 手牌
+ * @param deck 剩余牌
+ * @param pinned 固定花色
+ * @return 花色置换
+ */
+SuitMap Canonicalize(std::span<const PackedCard> hand, std::span<const PackedCard> deck, SuitMask pinned);
+
+/**
+ * 就地重标快照中手牌与剩余牌的花色，牌的位置不变。
+ *
+ * @param map 花色置换
+ * @param state 快照
+ */
+void Apply(const SuitMap& map, GameStateSnapshot& state);
+
+/**
+ * 计算规范代表的 Zobrist 键。
+ *
+ * 同构局面得到相同的键，可直接作为置换表或缓存的键。
+ *
+ * @param state 快照
+ * @param pinned 固定花色
+ * @return 规范局面键
+ */
+std::uint64_t CanonicalZobrist(const GameStateSnapshot& state, SuitMask pinned);
+
+} // namespace SuitIsomorphism
@@ -0,0 +1,83 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// 数据字布局：低 48 位为有符号值，其上 8 位为深度 + 1（0 表示空槽），最高 8 位为界类型。
+constexpr int VALUE_BITS = 48;
+constexpr std::uint64_t VALUE_MASK = (1ULL << VALUE_BITS) - 1;
+constexpr std::int64_t VALUE_MAX = (1LL << (VALUE_BITS - 1)) - 1;
+constexpr std::int64_t VALUE_MIN = -(1LL << (VALUE_BITS - 1));
+
+int storedDepth(std::uint64_t data) { return static_cast<int>((data >> VALUE_BITS) & 0xFF); }
+
+} // namespace
+
+TranspositionTable::TranspositionTable(std::size_t capacity) {
+    const std::size_t buckets = std::bit_ceil(std::max<std::size_t>(capacity / 2, 1));
+    m_buckets = std::make_unique<Bucket[]>(buckets);
+    m_mask = buckets - 1;
+}
+
+bool TranspositionTable::probe(std::uint64_t key, TtEntry& out) const {
+    const Bucket& bucket = m_buckets[key & m_mask];
+    for (const Slot* slot : {&bucket.deep, &bucket.recent}) {
+        const std::uint64_t data = slot->data.load(std::memory_order_relaxed);
+        const std::uint64_t check = slot->check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && storedDepth(data) != 0) {
+            out = unpack(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(std::uint64_t key, const TtEntry& entry) {
+    Bucket& bucket = m_buckets[key & m_mask];
+    const std::uint64_t data = pack(entry);
+
+    const std::uint64_t deepData = bucket.deep.data.load(std::memory_order_relaxed);
+    const std::uint64_t deepKey = bucket.deep.check.load(std::memory_order_relaxed) ^ deepData;
+    const int deepDepth = storedDepth(deepData);
+
+    if (deepKey != key && storedDepth(data) < deepDepth) {
+        bucket.recent.data.store(data, std::memory_order_relaxed);
+        bucket.recent.check.store(key ^ data, std::memory_order_relaxed);
+        return;
+    }
+    // 被挤出的深层结果降级到总是替换槽，而不是直接丢弃。
+    if (deepKey != key && deepDepth != 0) {
+        bucket.recent.data.store(deepData, std::memory_order_relaxed);
+        bucket.recent.check.store(deepKey ^ deepData, std::memory_order_relaxed);
+    }
+    bucket.deep.data.store(data, std::memory_order_relaxed);
+    bucket.deep.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i <= m_mask; ++i) {
+        for (Slot* slot : {&m_buckets[i].deep, &m_buckets[i].recent}) {
+            slot->data.store(0, std::memory_order_relaxed);
+            slot->check.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::uint64_t TranspositionTable::pack(const TtEntry& entry) {
+    const std::int64_t value = std::clamp<std::int64_t>(entry.value, VALUE_MIN, VALUE_MAX);
+    const auto depth = static_cast<std::uint64_t>(std::clamp(entry.depth, 0, MAX_DEPTH) + 1);
+    return (static_cast<std::uint64_t>(value) & VALUE_MASK) |
+           (depth << VALUE_BITS) |
+           (static_cast<std::uint64_t>(entry.bound) << (VALUE_BITS + 8));
+}
+
+TtEntry TranspositionTable::unpack(std::uint64_t data) {
+    TtEntry entry;
+    // 左移再算术右移，恢复 48 位值的符号。
+    entry.value = static_cast<std::int64_t>(data << (64 - VALUE_BITS)) >> (64 - VALUE_BITS);
+    entry.depth = storedDepth(data) - 1;
+    entry.bound = static_cast<TtEntry::Bound>(data >> (VALUE_BITS + 8));
+    return entry;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * 置换表中缓存的一次评估。
+ */
+struct TtEntry {
+    enum class Bound : std::uint8_t {
+        Exact,  // value 为精确值
+        Lower,  // 真实值不小于 value
+        Upper   // 真实值不大于 value
+    };
+
+    std::int64_t value = 0;  // 仅保留低 48 位，超出范围的值会被截断到边界
+    int depth = 0;           // 剩余搜索深度，取值 [0, MAX_DEPTH]
+    Bound bound = Bound::Exact;
+};
+
+/**
+ * 无锁定长置换表。
+ *
+ * 每个槽位存两个 64 位原子字：数据字与“键 ^ 数据字”。读取时两者异或还原出键，
+ * 与查询键不符即视为未命中，因此并发写入撕裂的槽位只会表现为未命中，无需加锁。
+ * 每个桶含两个槽位：深度优先槽只被同键或不浅于它的结果覆盖，被挤出的旧结果降级到
+ * 总是替换槽；更浅的结果直接写入总是替换槽，数量最多的浅层子问题也能留在表中。
+ * 多线程可共享同一张表，probe 与 store 都只访问同一缓存行内的一个桶。
+ */
+class TranspositionTable {
+public:
+    static constexpr int MAX_DEPTH = 254;
+
+    /**
+     * 构造置换表。
+     *
+     * @param capacity 槽位数，按桶向上取整到 2 的幂，至少一个桶
+     */
+    explicit TranspositionTable(std::size_t capacity);
+
+    /**
+     * 查询缓存。
+     *
+     * @param key 局面键
+     * @param out 命中时写入的条目
+     * @return 是否命中
+     */
+    bool probe(std::uint64_t key, TtEntry& out) const;
+
+    /**
+     * 写入缓存，按深度决定写入深度优先槽还是总是替换槽。
+     *
+     * @param key 局面键
+     * @param entry 条目
+     */
+    void store(std::uint64_t key, const TtEntry& entry);
+
+    /**
+     * 清空全部槽位。非线程安全，调用时不能有并发的 probe/store。
+     */
+    void clear();
+
+    /**
+     * 获取槽位数。
+     *
+     * @return 槽位数
+     */
+    std::size_t capacity() const { return (m_mask + 1) * 2; }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check{0};  // key ^ data
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    struct alignas(32) Bucket {
+        Slot deep;    // 深度优先
+        Slot recent;  // 总是替换
+    };
+
+    static std::uint64_t pack(const TtEntry& entry);
+    static TtEntry unpack(std::uint64_t data);
+
+    std::unique_ptr<Bucket[]> m_buckets;
+    std::size_t m_mask = 0;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace WorkStealing {
+
+/**
+ * 单个工作线程持有的待处理下标区间。
+ *
+ * 按缓存行对齐，避免相邻线程的区间更新互相失效。
+ */
+struct alignas(64) WorkerRange {
+    std::mutex lock;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
+
+/**
+ * 以区间窃取方式并行处理 [0, count) 的每个下标。
+ *
+ * 下标先均分给各线程；线程从自己区间的头部逐个取任务，
+ * 区间耗尽后依次探查其他线程，从对方尾部窃取剩余任务的一半。
+ * 任务不会在执行中产生新任务，因此一轮探查全部落空即可退出。
+ * 锁只在取下标与窃取时短暂持有，任务本身无锁执行。
+ *
+ * fn 以 (index, worker) 调用，worker 为 [0, threads) 内的线程编号，
+ * 调用方可据此写入线程私有缓冲，避免共享可变状态。
+ *
+ * @param count 任务数
+ * @param threads 线程数，0 表示使用硬件并发数
+ * @param fn 任务函数
+ */
+template <typename Fn>
+void ParallelFor(std::size_t count, unsigned threads, Fn&& fn) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(count, 1)));
+
+    auto ranges = std::make_unique<WorkerRange[]>(threads);
+    for (unsigned w = 0; w < threads; ++w) {
+        ranges[w].begin = count * w / threads;
+        ranges[w].end = count * (w + 1) / threads;
+    }
+
+    const auto worker = [&](unsigned self) {
+        WorkerRange& own = ranges[self];
+        while (true) {
+            std::size_t index = 0;
+            bool hasTask = false;
+            {
+                std::lock_guard<std::mutex> guard(own.lock);
+                if (own.begin < own.end) {
+                    index = own.begin++;
+                    hasTask = true;
+                }
+            }
+            if (hasTask) {
+                fn(index, self);
+                continue;
+            }
+
+            bool stolen = false;
+            for (unsigned offset = 1; offset < threads && !stolen; ++offset) {
+                WorkerRange& victim = ranges[(self + offset) % threads];
+                std::size_t stealBegin = 0;
+                std::size_t stealEnd = 0;
+                {
+                    std::lock_guard<std::mutex> guard(victim.lock);
+                    const std::size_t remaining = victim.end - victim.begin;
+                    if (remaining == 0) continue;
+                    stealEnd = victim.end;
+                    stealBegin = victim.end - (remaining + 1) / 2;
+                    victim.end = stealBegin;
+                }
+                std::lock_guard<std::mutex> guard(own.lock);
+                own.begin = stealBegin;
+                own.end = stealEnd;
+                stolen = true;
+            }
+            if (!stolen) return;
+        }
+    };
+
+    std::vector<std::jthread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned w = 1; w < threads; ++w) {
+        pool.emplace_back(worker, w);
+    }
+    worker(0);
+}
+
+} // namespace WorkStealing
@@ -1,5 +1,6 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include "../Systems/Replay.hpp"
 
 class Game;
 
@@ -32,6 +33,20 @@ public:
      */
     virtual void handleEvent(Game& game, const sf::Event& event) = 0;
 
+    /**
+     * 执行一条玩家操作。
+     *
+     * handleEvent 把输入翻译为操作后经 Game::dispatchAction 进入此处，
+     * 录像回放也走同一入口，保证实时游玩与回放的规则路径一致。
+     *
+     * @param game 游戏宿主
+     * @param action 玩家操作
+     * @return 是否执行成功
+     */
+    virtual bool applyAction([[maybe_unused]] Game& game, [[maybe_unused]] const ReplayAction& action) {
+        return false;
+    }
+
     /**
      * 执行状态逻辑更新。
      *
@@ -5,6 +5,11 @@
 #include "../Systems/ScoringManager.hpp"
 #include "../Systems/RunFlow.hpp"
 #include "../Systems/CardSnapshotUtils.hpp"
+#include "../Systems/GameDatabase.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <thread>
 #include <iostream>
 
 void RunState::onEnter(Game& game) {
@@ -29,7 +34,7 @@ void RunState::onEnter(Game& game) {
 
     // 运行态入口统一重建牌堆，确保回合起点一致。
     ctx.deck.initStandardDeck();
-    ctx.deck.shuffle();
+    ctx.deck.shuffle(ctx.rng.stream(RngStreamId::Deck));
 
     // 进入状态后立即补满手牌，确保玩家始终可操作。
     refillHand(game);
@@ -38,63 +43,100 @@ void RunState::onEnter(Game& game) {
 
 void RunState::onExit([[maybe_unused]] Game& game) {
     // 当前状态数据由上下文托管，此处不主动清理以支持跨状态读取。
+    cancelHint();
+    cancelDiscardAdvice();
 }
 
 void RunState::handleEvent(Game& game, const sf::Event& event) {
     GameContext& ctx = game.getContext();
 
     if (event.type == sf::Event::KeyPressed) {
-        // 弃牌分支：先结算弃牌触发再执行移除，保持规则触发顺序一致。
         if (event.key.code == sf::Keyboard::D) {
-            const auto& discardedSnapshots = selectedSnapshots(ctx);
-            if (!discardedSnapshots.empty() && ctx.discardsLeft > 0) {
-
-                ScoreSummary discardSummary = ScoringManager::CalculateDiscardEffect(discardedSnapshots, &ctx.jokerArea());
-                if (discardSummary.dollars > 0) {
-                    game.spawnFloatingText("+$" + std::to_string(discardSummary.dollars), 
-                        sf::Vector2f(200, 600), sf::Color::Yellow);
-                    std::cout << "[Effect] Earned $" << discardSummary.dollars << " from discard." << std::endl;
-                }
-                RunFlow::ApplyDiscard(ctx, discardSummary);
-                removeSelectedCards(ctx);
-                refillHand(game);
-                markSelectionDirty();
-                std::cout << "[Action] Discard used." << std::endl;
-            }
+            game.dispatchAction({.op = ReplayOp::Discard});
         }
-
-        // 出牌分支：仅在有选牌且有手数时进入结算。
         if (event.key.code == sf::Keyboard::Enter) {
-            auto selected = selectedSnapshots(ctx);
-            if (!selected.empty() && ctx.handsLeft > 0) {
-                playHand(game, std::move(selected));
-            }
+            game.dispatchAction({.op = ReplayOp::Play});
+        }
+        if (event.key.code == sf::Keyboard::H) {
+            requestHint(game);
+        }
+        if (event.key.code == sf::Keyboard::E) {
+            requestDiscardAdvice(game);
         }
-
     }
 
     if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
         sf::Vector2f mousePos = game.getWindow().mapPixelToCoords(sf::Mouse::getPosition(game.getWindow()));
         if (ctx.hasHandArea()) {
             auto clickedCard = ctx.handArea().getCardAt(mousePos.x, mousePos.y);
-            if (clickedCard) {
-                // 选择上限为 5，模拟玩法节奏并减少异常牌型输入。
-                if (clickedCard->isSelected()) {
-                    clickedCard->toggleSelect();
-                    markSelectionDirty();
-                } else if (selectedSnapshots(ctx).size() < 5) {
-                    clickedCard->toggleSelect();
-                    markSelectionDirty();
-                }
+            const auto& cards = ctx.handArea().getCards();
+            const auto it = std::find(cards.begin(), cards.end(), clickedCard);
+            if (clickedCard && it != cards.end()) {
+                // 点击即翻转该牌的选中位，是否超出上限交给 applyAction 判定。
+                const auto bit = static_cast<std::uint16_t>(1u << (it - cards.begin()));
+                game.dispatchAction({.op = ReplayOp::Select, .mask = static_cast<std::uint16_t>(selectionMask(ctx) ^ bit)});
             }
         }
     }
 }
 
+bool RunState::applyAction(Game& game, const ReplayAction& action) {
+    GameContext& ctx = game.getContext();
+    // 手数耗尽即本局结束，之后的输入一律忽略，与无界面模拟的 GameOver 一致。
+    if (!ctx.hasHandArea() || ctx.handsLeft <= 0) return false;
+
+    switch (action.op) {
+        case ReplayOp::Select: {
+            auto& cards = ctx.handArea().getCards();
+            // 选择上限为 5，模拟玩法节奏并减少异常牌型输入。
+            if (std::popcount(action.mask) > HandEvaluator::MAX_PLAY_CARDS || (action.mask >> cards.size()) != 0) {
+                return false;
+            }
+            for (std::size_t i = 0; i < cards.size(); ++i) {
+                cards[i]->select(((action.mask >> i) & 1) != 0);
+            }
+            markSelectionDirty();
+            return true;
+        }
+
+        // 弃牌分支：先结算弃牌触发再执行移除，保持规则触发顺序一致。
+        case ReplayOp::Discard: {
+            const auto& discardedSnapshots = selectedSnapshots(ctx);
+            if (discardedSnapshots.empty() || ctx.discardsLeft <= 0) return false;
+
+            ScoreSummary discardSummary = ScoringManager::CalculateDiscardEffect(discardedSnapshots, &ctx.jokerArea().effectPipeline());
+            if (discardSummary.dollars > 0) {
+                game.spawnFloatingText("+$" + std::to_string(discardSummary.dollars), 
+                    sf::Vector2f(200, 600), sf::Color::Yellow);
+                std::cout << "[Effect] Earned $" << discardSummary.dollars << " from discard." << std::endl;
+            }
+            RunFlow::ApplyDiscard(ctx, discardSummary);
+            removeSelectedCards(ctx);
+            refillHand(game);
+            markSelectionDirty();
+            std::cout << "[Action] Discard used." << std::endl;
+            return true;
+        }
+
+        // 出牌分支：仅在有选牌时进入结算。
+        case ReplayOp::Play: {
+            auto selected = selectedSnapshots(ctx);
+            if (selected.empty()) return false;
+            playHand(game, std::move(selected));
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
 void RunState::update(Game& game, float dt) {
     GameContext& ctx = game.getContext();
     
     if (ctx.hasHandArea()) ctx.handArea().update(dt);
+    pollHint(game);
+    pollDiscardAdvice(game);
 
     // 每帧预览牌型，给玩家即时反馈，减少试错成本。
     const auto& selected = selectedSnapshots(ctx);
@@ -154,12 +196,13 @@ void RunState::playHand(Game& game, std::vector<CardSnapshot> selected) {
     HandResult handRes = HandEvaluator::Evaluate(selected);
     
     // 计分阶段需要手牌区和 Joker 区共同参与触发链。
+    CardSnapshotUtils::BuildHeldInHand(ctx.handArea(), m_heldScratch);
     ScoreSummary summary = ScoringManager::CalculateFinalScore(
         handRes.base_chips,
         handRes.base_mult,
         handRes.scoring_snapshots,
-        &ctx.handArea(),
-        &ctx.jokerArea()
+        m_heldScratch,
+        &ctx.jokerArea().effectPipeline()
     );
     
     // 结算后再生成反馈，避免视觉与逻辑结果不一致。
@@ -169,7 +212,7 @@ void RunState::playHand(Game& game, std::vector<CardSnapshot> selected) {
         pos.y -= 180.0f;
         game.spawnFloatingText("+" + std::to_string(card.chips), pos, sf::Color(100, 150, 255));
     }
-    game.spawnFloatingText(handRes.name, sf::Vector2f(640, 300), sf::Color::White);
+    game.spawnFloatingText(std::string(handRes.name), sf::Vector2f(640, 300), sf::Color::White);
 
     // 先移除再补牌，确保手牌数量统计正确。
     removeSelectedCards(ctx);
@@ -185,6 +228,158 @@ void RunState::playHand(Game& game, std::vector<CardSnapshot> selected) {
     }
 }
 
+void RunState::requestHint(Game& game) {
+    GameContext& ctx = game.getContext();
+    if (m_hint.valid() || !ctx.hasHandArea() || !ctx.hasJokerArea() || !ctx.hasDatabase() || ctx.handsLeft <= 0) {
+        return;
+    }
+
+    GameStateSnapshot snapshot;
+    m_hintHand.clear();
+    if (!snapshot.captureContext(ctx)) {
+        std::cerr << "[Warning] Hint unavailable: deck exceeds snapshot capacity" << std::endl;
+        return;
+    }
+    for (const auto& card : ctx.handArea().getCards()) {
+        if (!snapshot.hand.push_back(GameStateSnapshot::Pack(CardSnapshotUtils::FromCard(*card)))) {
+            std::cerr << "[Warning] Hint unavailable: hand exceeds snapshot capacity" << std::endl;
+            m_hintHand.clear();
+            return;
+        }
+        m_hintHand.push_back(card.get());
+    }
+
+    // 快照中的 Joker 以排序 ID 池下标表示，与 RunSimulator 一致。
+    std::vector<std::string> pool = ctx.db().getAllJokerIds();
+    std::sort(pool.begin(), pool.end());
+    for (const auto& card : ctx.jokerArea().getCards()) {
+        const auto it = std::lower_bound(pool.begin(), pool.end(), card->getJokerId());
+        if (it == pool.end() || *it != card->getJokerId()) continue;
+        snapshot.jokers.push_back(static_cast<std::uint8_t>(it - pool.begin()));
+    }
+
+    MctsConfig config;
+    config.timeBudgetMs = 300;
+    config.seed = ctx.rng.seed() ^ static_cast<std::uint64_t>(ctx.currentScore);
+    config.cancel = &m_hintCancel;
+    // 留一个核心给渲染线程。
+    config.threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+    m_hintCancel.store(false);
+    const GameDatabase* db = &ctx.db();
+    m_hint = std::async(std::launch::async, [db, snapshot, config] {
+        return MctsAdvisor::Decide(*db, snapshot, config);
+    });
+    std::cout << "[Hint] Thinking..." << std::endl;
+}
+
+void RunState::pollHint(Game& game) {
+    if (!m_hint.valid() || m_hint.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+    const MctsDecision decision = m_hint.get();
+    GameContext& ctx = game.getContext();
+    if (decision.choices.empty() || !ctx.hasHandArea()) return;
+
+    // 搜索期间玩家已出牌或弃牌时，建议对应的是旧手牌，直接丢弃。
+    const auto& cards = ctx.handArea().getCards();
+    const bool sameHand = std::equal(cards.begin(), cards.end(), m_hintHand.begin(), m_hintHand.end(),
+        [](const std::shared_ptr<Card>& card, const Card* previous) { return card.get() == previous; });
+    if (!sameHand) return;
+
+    const MctsChoice& best = decision.choices.front();
+    const bool play = best.action.kind == SimAction::Kind::Play;
+    game.dispatchAction({.op = ReplayOp::Select, .mask = best.action.cardMask});
+    game.spawnFloatingText(
+        std::string(play ? "HINT: PLAY " : "HINT: DISCARD ") + "CLEAR " + std::to_string(static_cast<int>(best.clearRate * 100)) + "%",
+        sf::Vector2f(640, 360),
+        sf::Color(120, 220, 255)
+    );
+    std::cout << "[Hint] " << (play ? "Play" : "Discard") << " mask=" << best.action.cardMask
+              << " clear=" << static_cast<int>(best.clearRate * 100) << "%"
+              << " reward=" << best.meanReward
+              << " visits=" << best.visits << " iterations=" << decision.iterations << std::endl;
+}
+
+void RunState::cancelHint() {
+    if (!m_hint.valid()) return;
+    m_hintCancel.store(true);
+    m_hint.wait();
+    m_hint = {};
+}
+
+void RunState::requestDiscardAdvice(Game& game) {
+    GameContext& ctx = game.getContext();
+    if (m_discardAdvice.valid() || !ctx.hasHandArea() || !ctx.hasJokerArea() || ctx.discardsLeft <= 0) return;
+
+    std::vector<CardSnapshot> hand;
+    m_discardHand.clear();
+    for (const auto& card : ctx.handArea().getCards()) {
+        hand.push_back(CardSnapshotUtils::FromCard(*card));
+        m_discardHand.push_back(card.get());
+    }
+
+    DiscardConfig config;
+    config.need = ctx.targetScore - ctx.currentScore;
+    config.cancel = &m_discardCancel;
+    config.threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+    // Joker 区在运行态内不变，离开运行态前会等待任务结束，流水线中的效果指针始终有效。
+    m_discardCancel.store(false);
+    DiscardAdvisor* advisor = &m_discardAdvisor;
+    m_discardAdvice = std::async(std::launch::async,
+        [advisor, hand = std::move(hand), deck = ctx.deck, jokers = ctx.jokerArea().effectPipeline(), config] {
+            return advisor->advise(hand, deck, &jokers, config);
+        });
+    std::cout << "[Discard] Enumerating draws..." << std::endl;
+}
+
+void RunState::pollDiscardAdvice(Game& game) {
+    if (!m_discardAdvice.valid() ||
+        m_discardAdvice.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+
+    const DiscardAdvice advice = m_discardAdvice.get();
+    GameContext& ctx = game.getContext();
+    if (!advice.complete || advice.options.empty() || !ctx.hasHandArea()) return;
+
+    const auto& cards = ctx.handArea().getCards();
+    const bool sameHand = std::equal(cards.begin(), cards.end(), m_discardHand.begin(), m_discardHand.end(),
+        [](const std::shared_ptr<Card>& card, const Card* previous) { return card.get() == previous; });
+    if (!sameHand) return;
+
+    const DiscardEv& best = advice.options.front();
+    game.dispatchAction({.op = ReplayOp::Select, .mask = best.cardMask});
+    game.spawnFloatingText(
+        "EV " + std::to_string(static_cast<long long>(best.expectedScore)) +
+            " vs KEEP " + std::to_string(static_cast<long long>(advice.keepScore)),
+        sf::Vector2f(640, 360),
+        sf::Color(120, 220, 255)
+    );
+    for (std::size_t i = 0; i < std::min<std::size_t>(3, advice.options.size()); ++i) {
+        const DiscardEv& option = advice.options[i];
+        std::cout << "[Discard] mask=" << option.cardMask << " ev=" << option.expectedScore
+                  << " clear=" << static_cast<int>(option.clearChance * 100) << "%" << std::endl;
+    }
+    std::cout << "[Discard] keep=" << advice.keepScore << " evaluations=" << advice.evaluations << std::endl;
+}
+
+void RunState::cancelDiscardAdvice() {
+    if (!m_discardAdvice.valid()) return;
+    m_discardCancel.store(true);
+    m_discardAdvice.wait();
+    m_discardAdvice = {};
+}
+
+std::uint16_t RunState::selectionMask(GameContext& ctx) const {
+    std::uint16_t mask = 0;
+    const auto& cards = ctx.handArea().getCards();
+    for (std::size_t i = 0; i < cards.size(); ++i) {
+        if (cards[i]->isSelected()) mask |= static_cast<std::uint16_t>(1u << i);
+    }
+    return mask;
+}
+
 const std::vector<CardSnapshot>& RunState::selectedSnapshots(GameContext& ctx) {
     if (m_selectionDirty) {
         m_selectedCache = CardSnapshotUtils::BuildSelected(ctx.handArea());
@@ -2,6 +2,11 @@
 
 #include "IGameState.hpp"
 #include "../Systems/CardSnapshot.hpp"
+#include "../Sim/DiscardAdvisor.hpp"
+#include "../Sim/MctsAdvisor.hpp"
+#include <atomic>
+#include <cstdint>
+#include <future>
 #include <vector>
 
 class Game;
@@ -10,6 +15,11 @@ struct GameContext;
 
 class RunState : public IGameState {
 public:
+    ~RunState() override {
+        cancelHint();
+        cancelDiscardAdvice();
+    }
+
     /**
      * 进入运行状态。
      *
@@ -32,6 +42,15 @@ public:
      */
     void handleEvent(Game& game, const sf::Event& event) override;
 
+    /**
+     * 执行选牌、出牌或弃牌操作。
+     *
+     * @param game 游戏宿主
+     * @param action 玩家操作
+     * @return 是否执行成功
+     */
+    bool applyAction(Game& game, const ReplayAction& action) override;
+
     /**
      * 更新运行态逻辑。
      *
@@ -60,6 +79,56 @@ private:
      */
     const std::vector<CardSnapshot>& selectedSnapshots(GameContext& ctx);
 
+    /**
+     * 在后台线程启动一次 MCTS 出牌建议。
+     *
+     * 搜索使用局面快照，不触碰卡牌对象，主循环继续按帧运行。
+     *
+     * @param game 游戏宿主
+     */
+    void requestHint(Game& game);
+
+    /**
+     * 轮询后台建议，完成且手牌未变时选中建议的牌。
+     *
+     * @param game 游戏宿主
+     */
+    void pollHint(Game& game);
+
+    /**
+     * 通知后台搜索尽快结束并等待其返回。
+     */
+    void cancelHint();
+
+    /**
+     * 在后台线程计算一次精确期望弃牌建议。
+     *
+     * 任务持有手牌、牌堆与 Joker 流水线的拷贝，主循环继续按帧运行。
+     *
+     * @param game 游戏宿主
+     */
+    void requestDiscardAdvice(Game& game);
+
+    /**
+     * 轮询后台弃牌建议，完成且手牌未变时选中期望最高的弃牌组合。
+     *
+     * @param game 游戏宿主
+     */
+    void pollDiscardAdvice(Game& game);
+
+    /**
+     * 通知后台弃牌枚举尽快结束并等待其返回。
+     */
+    void cancelDiscardAdvice();
+
+    /**
+     * 计算手牌选中掩码。
+     *
+     * @param ctx 运行上下文
+     * @return 第 i 位表示手牌第 i 张被选中
+     */
+    std::uint16_t selectionMask(GameContext& ctx) const;
+
     /**
      * 标记选牌缓存失效。
      */
@@ -92,4 +161,18 @@ private:
 
     std::vector<CardSnapshot> m_selectedCache;
     bool m_selectionDirty = true;
+
+    // 出牌时的手持牌快照缓冲，跨出牌复用容量。
+    std::vector<CardSnapshot> m_heldScratch;
+
+    // 取消标志需比 future 后析构，保证等待期间仍可读取。
+    std::atomic<bool> m_hintCancel{false};
+    std::future<MctsDecision> m_hint;
+    std::vector<const Card*> m_hintHand;  // 发起建议时的手牌，用于丢弃过期结果
+
+    // 顾问只由后台任务访问，同一时刻至多一个任务；手牌未变时重复请求直接命中其缓存。
+    DiscardAdvisor m_discardAdvisor;
+    std::atomic<bool> m_discardCancel{false};
+    std::future<DiscardAdvice> m_discardAdvice;
+    std::vector<const Card*> m_discardHand;
 };
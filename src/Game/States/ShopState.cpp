@@ -4,6 +4,7 @@
 #include "../Systems/GameDatabase.hpp"
 #include "../Systems/ShopFlow.hpp"
 #include "../Systems/ShopRestock.hpp"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <vector>
@@ -29,16 +30,12 @@ void ShopState::handleEvent(Game& game, const sf::Event& event) {
     if (event.type == sf::Event::KeyPressed) {
         // 下一轮切换入口。
         if (event.key.code == sf::Keyboard::N) {
-            game.changeState(std::make_unique<RunState>());
+            game.dispatchAction({.op = ReplayOp::NextRound});
             return;
         }
         
-        // 刷新分支统一通过 ShopFlow 扣费，保持规则一致。
         if (event.key.code == sf::Keyboard::R) {
-            if (ShopFlow::TryReroll(ctx)) {
-                restockShop(game);
-                m_pendingPurchase.reset();
-            }
+            game.dispatchAction({.op = ReplayOp::Reroll});
         }
     }
 
@@ -52,22 +49,11 @@ void ShopState::handleEvent(Game& game, const sf::Event& event) {
         auto pendingCard = m_pendingPurchase.lock();
 
         if (pendingCard && clickedJoker) {
-            int cost = pendingCard->getCost();
-            if (ShopFlow::TrySpend(ctx, cost)) {
-                
-                ctx.jokerArea().takeCard(clickedJoker.get());
-
-                if (auto newCard = ctx.shopArea().takeCard(pendingCard.get())) {
-                    newCard->setColor(sf::Color::White);
-                    ctx.jokerArea().addCard(newCard);
-                }
-
-                m_pendingPurchase.reset();
-                ui.setShopMessage("SHOP PHASE\n[Left Click] Buy Joker\n[N] Next Round", sf::Color::Yellow);
-                
-                ctx.jokerArea().alignCards();
-                ctx.shopArea().alignCards();
-            }
+            game.dispatchAction({
+                .op = ReplayOp::Replace,
+                .shopIndex = indexOf(ctx.shopArea(), pendingCard.get()),
+                .jokerIndex = indexOf(ctx.jokerArea(), clickedJoker.get()),
+            });
             return;
         }
 
@@ -75,29 +61,15 @@ void ShopState::handleEvent(Game& game, const sf::Event& event) {
         auto clickedShopCard = ctx.shopArea().getCardAt(mousePos.x, mousePos.y);
         if (clickedShopCard) {
             int cost = clickedShopCard->getCost();
-            const auto decision = ShopFlow::EvaluatePurchase(ctx, cost);
+            const int ownedJokers = static_cast<int>(ctx.jokerArea().getCards().size());
+            const auto decision = ShopFlow::EvaluatePurchase(ctx, cost, ownedJokers);
             if (!decision.affordable) return;
             
             // 有空槽时直接购入，减少不必要的替换步骤。
             if (!decision.requiresReplace) {
-                if (!ShopFlow::TrySpend(ctx, cost)) return;
-                
-                if (auto newCard = ctx.shopArea().takeCard(clickedShopCard.get())) {
-                    newCard->setColor(sf::Color::White);
-                    ctx.jokerArea().addCard(newCard);
-                }
-                
-                // 清理旧高亮，避免多张候选牌同时高亮造成误导。
-                if (auto oldPending = m_pendingPurchase.lock()) {
-                    oldPending->setColor(sf::Color::White);
-                }
-                m_pendingPurchase.reset();
-
-                ui.setShopMessage("SHOP PHASE\n[Left Click] Buy Joker\n[N] Next Round", sf::Color::Yellow);
-                ctx.jokerArea().alignCards();
-                ctx.shopArea().alignCards();
+                game.dispatchAction({.op = ReplayOp::Buy, .shopIndex = indexOf(ctx.shopArea(), clickedShopCard.get())});
             }
-            // 无空槽时进入“先选商品，再选替换目标”流程。
+            // 无空槽时进入“先选商品，再选替换目标”流程；待替换状态只属于界面，不进录像。
             else {
                 if (auto oldPending = m_pendingPurchase.lock()) {
                     oldPending->setColor(sf::Color::White);
@@ -112,11 +84,60 @@ void ShopState::handleEvent(Game& game, const sf::Event& event) {
 
     // 右键随时取消替换流程，降低误操作成本。
     if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Right) {
-        if (auto pendingCard = m_pendingPurchase.lock()) {
-            pendingCard->setColor(sf::Color::White);
+        clearPending(game);
+    }
+}
+
+bool ShopState::applyAction(Game& game, const ReplayAction& action) {
+    GameContext& ctx = game.getContext();
+    if (!ctx.hasShopArea() || !ctx.hasJokerArea()) return false;
+
+    switch (action.op) {
+        case ReplayOp::NextRound:
+            game.changeState(std::make_unique<RunState>());
+            return true;
+
+        // 刷新分支统一通过 ShopFlow 扣费，保持规则一致。
+        case ReplayOp::Reroll:
+            if (!ShopFlow::TryReroll(ctx)) return false;
+            restockShop(game);
+            m_pendingPurchase.reset();
+            return true;
+
+        case ReplayOp::Buy:
+        case ReplayOp::Replace: {
+            auto& offers = ctx.shopArea().getCards();
+            auto& owned = ctx.jokerArea().getCards();
+            if (action.shopIndex < 0 || action.shopIndex >= static_cast<int>(offers.size())) return false;
+
+            Card* offer = offers[static_cast<std::size_t>(action.shopIndex)].get();
+            const int cost = offer->getCost();
+            const auto decision = ShopFlow::EvaluatePurchase(ctx, cost, static_cast<int>(owned.size()));
+            // Buy 只用于有空槽，Replace 只用于满槽，与无界面模拟的判定保持一致。
+            const bool replacing = action.op == ReplayOp::Replace;
+            if (!decision.affordable || decision.requiresReplace != replacing) return false;
+            if (replacing && (action.jokerIndex < 0 || action.jokerIndex >= static_cast<int>(owned.size()))) {
+                return false;
+            }
+            if (!ShopFlow::TrySpend(ctx, cost)) return false;
+
+            if (replacing) {
+                ctx.jokerArea().takeCard(owned[static_cast<std::size_t>(action.jokerIndex)].get());
+            }
+            if (auto newCard = ctx.shopArea().takeCard(offer)) {
+                newCard->setColor(sf::Color::White);
+                ctx.jokerArea().addCard(newCard);
+            }
+
+            // 清理旧高亮，避免多张候选牌同时高亮造成误导。
+            clearPending(game);
+            ctx.jokerArea().alignCards();
+            ctx.shopArea().alignCards();
+            return true;
         }
-        m_pendingPurchase.reset();
-        ui.setShopMessage("SHOP PHASE\n[Left Click] Buy Joker\n[N] Next Round", sf::Color::Yellow);
+
+        default:
+            return false;
     }
 }
 
@@ -155,7 +176,9 @@ void ShopState::restockShop(Game& game) {
     while (!ctx.shopArea().getCards().empty()) ctx.shopArea().removeCard(0);
 
     // 动态读取 ID 池，避免新增 joker 后还要改硬编码列表。
+    // 数据库按哈希表存储，排序后商品池顺序才与种子一一对应。
     std::vector<std::string> jokerPool = ctx.db().getAllJokerIds();
+    std::sort(jokerPool.begin(), jokerPool.end());
     
     // FIXME: 当前仅打印警告，后续可增加“空池兜底商品”策略。
     if (jokerPool.empty()) {
@@ -163,7 +186,7 @@ void ShopState::restockShop(Game& game) {
         return;
     }
 
-    std::vector<std::string> pickedIds = ShopRestock::PickIdsWithStdRand(jokerPool, 3);
+    std::vector<std::string> pickedIds = ShopRestock::PickIds(jokerPool, 3, ctx.rng.stream(RngStreamId::Shop));
 
     // 固定补 3 张，控制商店决策密度与回合节奏。
     for (const auto& id : pickedIds) {
@@ -173,3 +196,19 @@ void ShopState::restockShop(Game& game) {
     }
     ctx.shopArea().alignCards();
 }
+
+void ShopState::clearPending(Game& game) {
+    if (auto pendingCard = m_pendingPurchase.lock()) {
+        pendingCard->setColor(sf::Color::White);
+    }
+    m_pendingPurchase.reset();
+    game.getUI().setShopMessage("SHOP PHASE\n[Left Click] Buy Joker\n[N] Next Round", sf::Color::Yellow);
+}
+
+int ShopState::indexOf(CardArea& area, const Card* card) {
+    const auto& cards = area.getCards();
+    for (std::size_t i = 0; i < cards.size(); ++i) {
+        if (cards[i].get() == card) return static_cast<int>(i);
+    }
+    return -1;
+}
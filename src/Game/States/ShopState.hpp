@@ -5,6 +5,7 @@
 
 class Game;
 class Card;
+class CardArea;
 
 class ShopState : public IGameState {
 public:
@@ -30,6 +31,15 @@ public:
      */
     void handleEvent(Game& game, const sf::Event& event) override;
 
+    /**
+     * 执行购买、替换、刷新或进入下一轮操作。
+     *
+     * @param game 游戏宿主
+     * @param action 玩家操作
+     * @return 是否执行成功
+     */
+    bool applyAction(Game& game, const ReplayAction& action) override;
+
     /**
      * 更新商店逻辑。
      *
@@ -58,4 +68,20 @@ private:
      * @param game 游戏宿主
      */
     void restockShop(Game& game);
+
+    /**
+     * 取消待替换状态并恢复商店提示。
+     *
+     * @param game 游戏宿主
+     */
+    void clearPending(Game& game);
+
+    /**
+     * 查找卡牌在区域中的下标。
+     *
+     * @param area 卡牌区域
+     * @param card 卡牌
+     * @return 下标；不存在时为 -1
+     */
+    static int indexOf(CardArea& area, const Card* card);
 };
@@ -56,6 +56,22 @@ inline std::vector<CardSnapshot> BuildHeldInHand(CardArea& area) {
     return snapshots;
 }
 
+/**
+ * 将“手持但未选中”快照写入复用缓冲。
+ *
+ * 先清空再填充，缓冲容量在多次结算间保留，稳定运行后不再分配。
+ *
+ * @param area 手牌区域
+ * @param out 输出缓冲
+ */
+inline void BuildHeldInHand(CardArea& area, std::vector<CardSnapshot>& out) {
+    out.clear();
+    for (const auto& cardPtr : area.getCards()) {
+        if (!cardPtr || cardPtr->isSelected()) continue;
+        out.push_back(FromCard(*cardPtr));
+    }
+}
+
 /**
  * 构建“已选中”快照列表。
  *
@@ -0,0 +1,223 @@
+#include "DeckOdds.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t RANK_COUNT = 13;
+constexpr std::size_t SUIT_COUNT = 4;  // 不含 Suit::None
+constexpr std::size_t ACE = RANK_COUNT - 1;
+
+// 帕斯卡三角，覆盖一副牌内的全部组合数；更大的牌堆退回逐项相乘。
+constexpr int PASCAL_SIZE = 65;
+const auto PASCAL = [] {
+    std::array<std::array<double, PASCAL_SIZE>, PASCAL_SIZE> table{};
+    for (int n = 0; n < PASCAL_SIZE; ++n) {
+        table[n][0] = 1.0;
+        for (int k = 1; k <= n; ++k) table[n][k] = table[n - 1][k - 1] + (k < n ? table[n - 1][k] : 0.0);
+    }
+    return table;
+}();
+
+double choose(int n, int k) {
+    if (k < 0 || k > n) return 0.0;
+    if (n < PASCAL_SIZE) return PASCAL[n][k];
+    double result = 1.0;
+    for (int i = 1; i <= k; ++i) result = result * (n - k + i) / i;
+    return result;
+}
+
+/**
+ * 每组至多抽 limit 张时恰好抽满 k 张的方案数（各组多项式相乘取 k 次系数）。
+ *
+ * limit < 0 的组表示手牌已满足目标，调用方应提前返回。
+ */
+double boundedWays(std::span<const std::pair<int, int>> groups, int freeCards, int k) {
+    std::vector<double> ways(static_cast<std::size_t>(k) + 1, 0.0);
+    for (int x = 0; x <= std::min(freeCards, k); ++x) ways[static_cast<std::size_t>(x)] = choose(freeCards, x);
+
+    std::vector<double> next(ways.size());
+    for (const auto& [available, limit] : groups) {
+        std::fill(next.begin(), next.end(), 0.0);
+        for (int used = 0; used <= k; ++used) {
+            const double base = ways[static_cast<std::size_t>(used)];
+            if (base == 0.0) continue;
+            for (int x = 0; x <= std::min({available, limit, k - used}); ++x) {
+                next[static_cast<std::size_t>(used + x)] += base * choose(available, x);
+            }
+        }
+        ways.swap(next);
+    }
+    return ways[static_cast<std::size_t>(k)];
+}
+
+double flushOdds(const DeckOdds::Counts& counts, int k, double total) {
+    std::array<std::pair<int, int>, SUIT_COUNT> groups{};
+    int suited = 0;
+    for (std::size_t s = 0; s < SUIT_COUNT; ++s) {
+        const int limit = 4 - counts.handSuits[s];
+        if (limit < 0) return 1.0;
+        groups[s] = {counts.deck.suits[s], limit};
+        suited += counts.deck.suits[s];
+    }
+    return 1.0 - boundedWays(groups, counts.deckSize - suited, k) / total;
+}
+
+double ofAKindOdds(const DeckOdds::Counts& counts, int need, int k, double total) {
+    std::array<std::pair<int, int>, RANK_COUNT> groups{};
+    for (std::size_t r = 0; r < RANK_COUNT; ++r) {
+        const int limit = need - 1 - counts.handRanks[r];
+        if (limit < 0) return 1.0;
+        groups[r] = {counts.deck.ranks[r], limit};
+    }
+    return 1.0 - boundedWays(groups, 0, k) / total;
+}
+
+double fullHouseOdds(const DeckOdds::Counts& counts, int k, double total) {
+    // 状态：至少 3 张的点数个数（封顶 2）× 是否另有恰好 2 张的点数 × 已抽张数。
+    using Layer = std::array<std::array<std::vector<double>, 2>, 3>;
+    const auto makeLayer = [k] {
+        Layer layer;
+        for (auto& row : layer) {
+            for (auto& ways : row) ways.assign(static_cast<std::size_t>(k) + 1, 0.0);
+        }
+        return layer;
+    };
+    Layer ways = makeLayer();
+    ways[0][0][0] = 1.0;
+
+    for (std::size_t r = 0; r < RANK_COUNT; ++r) {
+        Layer next = makeLayer();
+        const int held = counts.handRanks[r];
+        const int available = counts.deck.ranks[r];
+        for (int t = 0; t < 3; ++t) {
+            for (int p = 0; p < 2; ++p) {
+                for (int used = 0; used <= k; ++used) {
+                    const double base = ways[t][p][static_cast<std::size_t>(used)];
+                    if (base == 0.0) continue;
+                    for (int x = 0; x <= std::min(available, k - used); ++x) {
+                        const int have = held + x;
+                        const int nt = std::min(t + (have >= 3 ? 1 : 0), 2);
+                        const int np = p | (have == 2 ? 1 : 0);
+                        next[nt][np][static_cast<std::size_t>(used + x)] += base * choose(available, x);
+                    }
+                }
+            }
+        }
+        ways.swap(next);
+    }
+
+    const std::size_t last = static_cast<std::size_t>(k);
+    const double success = ways[2][0][last] + ways[2][1][last] + ways[1][1][last];
+    return success / total;
+}
+
+double straightOdds(const DeckOdds::Counts& counts, int k, double total) {
+    // A 同时位于两端，先枚举抽到的 A 张数，再对 2..K 做连续长度的状态转移。
+    constexpr int DONE = 5;
+    double success = 0.0;
+    const int aceAvailable = counts.deck.ranks[ACE];
+    for (int aceDrawn = 0; aceDrawn <= std::min(aceAvailable, k); ++aceDrawn) {
+        const bool acePresent = counts.handRanks[ACE] > 0 || aceDrawn > 0;
+        const int budget = k - aceDrawn;
+
+        // ways[run][used]，run 为以当前点数结尾的连续长度，DONE 表示已成顺。
+        std::array<std::vector<double>, DONE + 1> ways;
+        for (auto& row : ways) row.assign(static_cast<std::size_t>(budget) + 1, 0.0);
+        ways[acePresent ? 1 : 0][0] = 1.0;
+
+        for (std::size_t r = 0; r < ACE; ++r) {
+            std::array<std::vector<double>, DONE + 1> next;
+            for (auto& row : next) row.assign(static_cast<std::size_t>(budget) + 1, 0.0);
+            const int held = counts.handRanks[r];
+            const int available = counts.deck.ranks[r];
+            for (int run = 0; run <= DONE; ++run) {
+                for (int used = 0; used <= budget; ++used) {
+                    const double base = ways[static_cast<std::size_t>(run)][static_cast<std::size_t>(used)];
+                    if (base == 0.0) continue;
+                    for (int x = 0; x <= std::min(available, budget - used); ++x) {
+                        const bool present = held > 0 || x > 0;
+                        const int nextRun = run == DONE ? DONE : (present ? std::min(run + 1, DONE) : 0);
+                        next[static_cast<std::size_t>(nextRun)][static_cast<std::size_t>(used + x)] +=
+                            base * choose(available, x);
+                    }
+                }
+            }
+            ways.swap(next);
+        }
+
+        const std::size_t last = static_cast<std::size_t>(budget);
+        // 10-J-Q-K 连续时，A 补成最高的顺子。
+        double hits = ways[DONE][last];
+        if (acePresent) hits += ways[4][last];
+        success += hits * choose(aceAvailable, aceDrawn);
+    }
+    return success / total;
+}
+
+} // namespace
+
+DeckOdds::Counts DeckOdds::Count(std::span<const CardSnapshot> hand, const Deck& deck) {
+    Counts counts;
+    for (const CardSnapshot& card : hand) {
+        const auto rank = static_cast<std::size_t>(card.rank) - static_cast<std::size_t>(Rank::Two);
+        const auto suit = static_cast<std::size_t>(card.suit);
+        if (rank < counts.handRanks.size()) ++counts.handRanks[rank];
+        if (suit < counts.handSuits.size()) ++counts.handSuits[suit];
+    }
+    counts.deck = deck.counts();
+    counts.deckSize = deck.getRemainingCount();
+    return counts;
+}
+
+double DeckOdds::probability(const Counts& counts, const DrawQuery& query) {
+    const int k = std::clamp(query.draws, 0, counts.deckSize);
+
+    Signature signature;
+    auto& bytes = signature.bytes;
+    bytes[0] = static_cast<std::uint8_t>(query.target);
+    bytes[1] = static_cast<std::uint8_t>(query.target == DrawTarget::OfAKind ? std::clamp(query.count, 0, 255) : 0);
+    bytes[2] = static_cast<std::uint8_t>(std::min(k, 255));
+
+    // 每组两字节（手牌张数、剩余张数）；与具体点数/花色无关的目标按组排序以合并等价签名。
+    std::array<std::uint16_t, RANK_COUNT> groups{};
+    std::size_t groupCount = 0;
+    if (query.target == DrawTarget::Flush) {
+        int suited = 0;
+        for (std::size_t s = 0; s < SUIT_COUNT; ++s) {
+            groups[groupCount++] = static_cast<std::uint16_t>((counts.handSuits[s] << 8) | counts.deck.suits[s]);
+            suited += counts.deck.suits[s];
+        }
+        bytes[3] = static_cast<std::uint8_t>(std::min(counts.deckSize - suited, 255));
+    } else {
+        for (std::size_t r = 0; r < RANK_COUNT; ++r) {
+            groups[groupCount++] = static_cast<std::uint16_t>((counts.handRanks[r] << 8) | counts.deck.ranks[r]);
+        }
+    }
+    if (query.target != DrawTarget::Straight) std::sort(groups.begin(), groups.begin() + groupCount);
+    for (std::size_t i = 0; i < groupCount; ++i) {
+        bytes[4 + 2 * i] = static_cast<std::uint8_t>(groups[i] >> 8);
+        bytes[5 + 2 * i] = static_cast<std::uint8_t>(groups[i]);
+    }
+
+    if (const auto it = m_cache.find(signature); it != m_cache.end()) return it->second;
+
+    const double total = choose(counts.deckSize, k);
+    double result = 0.0;
+    switch (query.target) {
+        case DrawTarget::Flush:     result = flushOdds(counts, k, total); break;
+        case DrawTarget::Straight:  result = straightOdds(counts, k, total); break;
+        case DrawTarget::FullHouse: result = fullHouseOdds(counts, k, total); break;
+        case DrawTarget::OfAKind:   result = ofAKindOdds(counts, std::max(query.count, 1), k, total); break;
+    }
+    result = std::clamp(result, 0.0, 1.0);
+    m_cache.emplace(signature, result);
+    return result;
+}
+
+std::size_t DeckOdds::SignatureHash::operator()(const Signature& signature) const {
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const std::uint8_t byte : signature.bytes) hash = (hash ^ byte) * 0x100000001B3ULL;
+    return static_cast<std::size_t>(hash);
+}
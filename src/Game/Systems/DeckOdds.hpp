@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+
+#include "../Core/Deck.hpp"
+#include "CardSnapshot.hpp"
+
+/**
+ * 抽牌概率查询的目标牌型。
+ */
+enum class DrawTarget : std::uint8_t {
+    Flush,      // 某一花色凑满 5 张
+    Straight,   // 5 个连续点数，A 可作 1
+    FullHouse,  // 一个点数至少 3 张且另一个点数至少 2 张
+    OfAKind     // 某一点数至少 count 张
+};
+
+/**
+ * 抽牌概率查询。
+ */
+struct DrawQuery {
+    DrawTarget target = DrawTarget::Flush;
+    int draws = 1;   // 接下来抽的张数，超过剩余牌数时按剩余牌数计
+    int count = 2;   // 仅 OfAKind 使用
+};
+
+/**
+ * 剩余牌抽牌概率。
+ *
+ * 把“手牌 + 接下来 k 张”视为从剩余牌中无放回抽取 k 张后的并集，
+ * 按点数/花色张数做多元超几何计数，结果精确而非抽样估计。
+ * 计算只依赖张数统计：查询前把手牌与剩余牌压缩成签名，
+ * 对与点数或花色具体值无关的目标还会先排序签名，相同签名直接命中缓存。
+ *
+ * 缓存不加锁，每个使用方（界面、各个机器人线程）持有自己的实例。
+ */
+class DeckOdds {
+public:
+    /**
+     * 手牌与剩余牌的张数统计。
+     */
+    struct Counts {
+        std::array<std::uint8_t, 13> handRanks{};
+        std::array<std::uint8_t, 5> handSuits{};
+        DeckCounts deck;
+        int deckSize = 0;
+    };
+
+    /**
+     * 汇总手牌与牌堆的张数。
+     *
+     * 牌堆部分直接取 Deck 增量维护的统计，开销只与手牌张数有关。
+     *
+     * @param hand 手牌
+     * @param deck 牌堆
+     * @return 张数统计
+     */
+    static Counts Count(std::span<const CardSnapshot> hand, const Deck& deck);
+
+    /**
+     * 查询在接下来若干次抽牌内凑成目标牌型的概率。
+     *
+     * @param hand 手牌
+     * @param deck 牌堆
+     * @param query 查询
+     * @return 概率，手牌已满足目标时为 1
+     */
+    double probability(std::span<const CardSnapshot> hand, const Deck& deck, const DrawQuery& query) {
+        return probability(Count(hand, deck), query);
+    }
+
+    /**
+     * 按张数统计查询概率。
+     *
+     * @param counts 张数统计
+     * @param query 查询
+     * @return 概率
+     */
+    double probability(const Counts& counts, const DrawQuery& query);
+
+    /**
+     * 清空缓存。
+     */
+    void clear() { m_cache.clear(); }
+
+    std::size_t cacheSize() const { return m_cache.size(); }
+
+private:
+    /**
+     * 签名：目标、参数与每个点数（或花色）的“手牌张数 | 剩余张数”字节。
+     */
+    struct Signature {
+        std::array<std::uint8_t, 32> bytes{};
+
+        bool operator==(const Signature& other) const = default;
+    };
+
+    struct SignatureHash {
+        std::size_t operator()(const Signature& signature) const;
+    };
+
+    std::unordered_map<Signature, double, SignatureHash> m_cache;
+};
@@ -5,7 +5,6 @@
 #include <nlohmann/json.hpp>
 
 #include "JokerEffectFactory.hpp"
-#include "ResourceManager.hpp"
 
 using json = nlohmann::json;
 
@@ -16,10 +15,6 @@ void GameDatabase::recordError(const std::string& msg) {
     std::cerr << msg << std::endl;
 }
 
-void GameDatabase::setResourceManager(ResourceManager* resourceManager) {
-    m_resourceManager = resourceManager;
-}
-
 bool GameDatabase::loadJokers(const std::string& filepath) {
     m_jokerDb.clear();
 
@@ -50,34 +45,32 @@ bool GameDatabase::loadJokers(const std::string& filepath) {
         data.effectId = value.value("effect_id", "");
         data.params = value["params"];
 
+        // 表达式效果只在加载时编译一次，创建实例与结算阶段不再解析 JSON。
+        if (data.effectId == "Expr") {
+            std::string error;
+            data.program = JokerEffectFactory::Compile(data.params, error);
+            if (!data.program) {
+                recordError("[Error] Invalid joker expression (" + key + "): " + error);
+                continue;
+            }
+        }
+
         m_jokerDb[key] = data;
     }
     std::cout << "Loaded " << m_jokerDb.size() << " jokers." << std::endl;
     return true;
 }
 
-std::shared_ptr<Card> GameDatabase::createJoker(const std::string& jokerId) {
-    if (m_jokerDb.find(jokerId) == m_jokerDb.end()) {
-        recordError("[Error] Joker ID not found: " + jokerId);
-        return nullptr;
-    }
-
-    if (!m_resourceManager) {
-        recordError("[Error] ResourceManager is not set for GameDatabase.");
-        return nullptr;
-    }
-
-    sf::Texture& texture = m_resourceManager->getTexture("jokers");
-    const JokerData& data = m_jokerDb[jokerId];
-
-    auto card = std::make_shared<Card>(data.atlasIndex, texture);
-    card->setAbilityName(data.name);
-    card->setCost(data.cost);
-    card->setDescription(data.text + "\nPrice: $" + std::to_string(data.cost));
-    card->setBaseScale(2.0f);
-    card->setEffect(JokerEffectFactory::Create(data.effectId, data.params));
+const JokerData* GameDatabase::findJoker(const std::string& jokerId) const {
+    auto it = m_jokerDb.find(jokerId);
+    return it != m_jokerDb.end() ? &it->second : nullptr;
+}
 
-    return card;
+std::shared_ptr<IEffect> GameDatabase::createJokerEffect(const std::string& jokerId) const {
+    const JokerData* data = findJoker(jokerId);
+    if (!data) return nullptr;
+    return data->program ? JokerEffectFactory::CreateScripted(data->program)
+                         : JokerEffectFactory::Create(data->effectId, data->params);
 }
 
 bool GameDatabase::loadRanks(const std::string& filepath) {
@@ -6,12 +6,18 @@
 #include <vector>
 
 #include "../Data/JokerData.hpp"
-#include "../Objects/Card.hpp"
+#include "../Objects/CardModel.hpp"
 
+class Card;
+class IEffect;
 class ResourceManager;
 
 /**
  * 游戏静态数据仓库与对象工厂。
+ *
+ * 数据加载与效果创建不依赖图形库，可单独用于无界面模拟；
+ * 创建可渲染 Joker 的 createJoker 在 GameDatabaseCards.cpp 中实现，
+ * 只随图形客户端一起编译。
  */
 class GameDatabase {
 public:
@@ -45,6 +51,24 @@ public:
      */
     std::shared_ptr<Card> createJoker(const std::string& jokerId);
 
+    /**
+     * 查询 Joker 配置。
+     *
+     * @param jokerId Joker 配置 ID
+     * @return 配置；不存在返回 nullptr
+     */
+    const JokerData* findJoker(const std::string& jokerId) const;
+
+    /**
+     * 创建 Joker 效果对象。
+     *
+     * 不创建卡牌与纹理，供无界面编队直接使用。
+     *
+     * @param jokerId Joker 配置 ID
+     * @return 效果对象；ID 不存在或效果未知返回 nullptr
+     */
+    std::shared_ptr<IEffect> createJokerEffect(const std::string& jokerId) const;
+
     /**
      * 加载点数筹码配置。
      *
@@ -0,0 +1,35 @@
+#include "GameDatabase.hpp"
+
+#include "ResourceManager.hpp"
+#include "../Objects/Card.hpp"
+
+// 依赖 SFML 纹理的部分单独成文件，使 GameDatabase.cpp 可编入无界面核心库。
+
+void GameDatabase::setResourceManager(ResourceManager* resourceManager) {
+    m_resourceManager = resourceManager;
+}
+
+std::shared_ptr<Card> GameDatabase::createJoker(const std::string& jokerId) {
+    const JokerData* data = findJoker(jokerId);
+    if (!data) {
+        recordError("[Error] Joker ID not found: " + jokerId);
+        return nullptr;
+    }
+
+    if (!m_resourceManager) {
+        recordError("[Error] ResourceManager is not set for GameDatabase.");
+        return nullptr;
+    }
+
+    sf::Texture& texture = m_resourceManager->getTexture("jokers");
+
+    auto card = std::make_shared<Card>(data->atlasIndex, texture);
+    card->setJokerId(jokerId);
+    card->setAbilityName(data->name);
+    card->setCost(data->cost);
+    card->setDescription(data->text + "\nPrice: $" + std::to_string(data->cost));
+    card->setBaseScale(2.0f);
+    card->setEffect(createJokerEffect(jokerId));
+
+    return card;
+}
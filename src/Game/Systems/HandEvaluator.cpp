@@ -1,169 +1,539 @@
 #include "HandEvaluator.hpp"
+#include "ScoringManager.hpp"
+#include <array>
+#include <bit>
+#include <string_view>
+#include <cassert>
 #include <iostream>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BALATRO_HAND_AVX2 1
+#include <immintrin.h>
+#else
+#define BALATRO_HAND_AVX2 0
+#endif
+
+namespace {
+
+// 13 个点数计数槽的最低位。
+constexpr std::uint64_t RANK_NIBBLE_LSB = 0x1111111111111ULL;
+
+constexpr int rankBit(Rank rank) { return static_cast<int>(rank) - static_cast<int>(Rank::Two); }
+
 // 该表提供默认平衡值，确保在外部数据缺失时玩法仍可运行。
-static const std::map<PokerHandType, std::pair<int, int>> BASE_STATS = {
-    {PokerHandType::HighCard,      {5, 1}},
-    {PokerHandType::Pair,          {10, 2}},
-    {PokerHandType::TwoPair,       {20, 2}},
-    {PokerHandType::ThreeOfAKind,  {30, 3}},
-    {PokerHandType::Straight,      {30, 4}},
-    {PokerHandType::Flush,         {35, 4}},
-    {PokerHandType::FullHouse,     {40, 4}},
-    {PokerHandType::FourOfAKind,   {60, 7}},
-    {PokerHandType::StraightFlush, {100, 8}},
-    {PokerHandType::RoyalFlush,    {100, 8}}
+// 扩展牌型尚未开放，基础值保持为 0。
+constexpr std::array<BaseStats, 13> BASE_STATS = {{
+    {5, 1},    // HighCard
+    {10, 2},   // Pair
+    {20, 2},   // TwoPair
+    {30, 3},   // ThreeOfAKind
+    {30, 4},   // Straight
+    {35, 4},   // Flush
+    {40, 4},   // FullHouse
+    {60, 7},   // FourOfAKind
+    {100, 8},  // StraightFlush
+    {100, 8},  // RoyalFlush
+    {0, 0},    // FiveOfAKind
+    {0, 0},    // FlushFive
+    {0, 0},    // FlushHouse
+}};
+
+/**
+ * 13 bit 点数掩码的模式表。
+ *
+ * 顺子、皇家跨度与最高点数只取决于点数集合，
+ * 编译期枚举全部 8192 种掩码后运行期只需一次查表。
+ */
+namespace RankPattern {
+constexpr std::uint8_t TOP_RANK = 0x0F;   // 最高点数的位序号
+constexpr std::uint8_t STRAIGHT = 0x10;   // 互不重复时可构成顺子（含 A-2-3-4-5）
+constexpr std::uint8_t ROYAL_SPAN = 0x20; // 最小点数为 10 且包含 A
+constexpr int MASK_COUNT = 1 << 13;
+} // namespace RankPattern
+
+constexpr std::uint8_t makeRankPattern(unsigned mask) {
+    if (mask == 0) return 0;
+    std::uint8_t pattern = static_cast<std::uint8_t>(std::bit_width(mask) - 1);
+
+    // 常规顺子要求点数连续；低 A 顺子沿用“最小四张为 2/3/4/5 且含 A”的判定。
+    const unsigned run = mask >> std::countr_zero(mask);
+    const unsigned wheel = (1u << rankBit(Rank::Ace)) | 0xFu;
+    const bool contiguous = (run & (run + 1)) == 0;
+    if (std::popcount(mask) >= 5 && (contiguous || (mask & wheel) == wheel)) {
+        pattern |= RankPattern::STRAIGHT;
+    }
+
+    const unsigned aceBit = 1u << rankBit(Rank::Ace);
+    if (std::countr_zero(mask) == rankBit(Rank::Ten) && (mask & aceBit)) {
+        pattern |= RankPattern::ROYAL_SPAN;
+    }
+    return pattern;
+}
+
+constexpr auto RANK_PATTERN_TABLE = [] {
+    std::array<std::uint8_t, RankPattern::MASK_COUNT> table{};
+    for (unsigned mask = 0; mask < table.size(); ++mask) {
+        table[mask] = makeRankPattern(mask);
+    }
+    return table;
+}();
+
+// 抽查几个关键掩码，防止表生成逻辑回归。
+static_assert(RANK_PATTERN_TABLE[0x001F] & RankPattern::STRAIGHT);
+static_assert(RANK_PATTERN_TABLE[0x100F] & RankPattern::STRAIGHT);
+static_assert(!(RANK_PATTERN_TABLE[0x1017] & RankPattern::STRAIGHT));
+static_assert(RANK_PATTERN_TABLE[0x1F00] & RankPattern::ROYAL_SPAN);
+static_assert((RANK_PATTERN_TABLE[0x0105] & RankPattern::TOP_RANK) == 8);
+
+/**
+ * 找出计数恰为 k 的点数。
+ *
+ * 异或后为 0 的槽即命中，再把槽内 4 bit 折叠到最低位，
+ * 这样对子/三条/四条都能用一次 popcount 统计。
+ *
+ * @param counts 点数计数槽
+ * @param k 目标次数
+ * @return 命中点数所在槽最低位置 1 的掩码
+ */
+constexpr std::uint64_t ranksWithCount(std::uint64_t counts, std::uint64_t k) {
+    std::uint64_t x = counts ^ (RANK_NIBBLE_LSB * k);
+    x |= x >> 1;
+    x |= x >> 2;
+    return ~x & RANK_NIBBLE_LSB;
+}
+
+/**
+ * 选出点数落在给定槽掩码中的输入位置。
+ *
+ * @param packed 位编码手牌
+ * @param rankSlots ranksWithCount 产出的槽掩码
+ * @return 输入位置掩码
+ */
+std::uint16_t positionsOfRanks(const PackedHand& packed, std::uint64_t rankSlots) {
+    std::uint16_t mask = 0;
+    for (std::uint16_t m = packed.members; m != 0; m &= m - 1) {
+        const int i = std::countr_zero(m);
+        const unsigned r = (packed.card_ranks >> (4 * i)) & 0xF;
+        if ((rankSlots >> (4 * r)) & 1) mask |= static_cast<std::uint16_t>(1u << i);
+    }
+    return mask;
+}
+
+/**
+ * 牌型分类键。
+ *
+ * 一手牌的牌型与计分规则只取决于下列特征，
+ * 因此任意手牌都能无冲突地映射到 128 项的分类表中。
+ */
+namespace HandClassKey {
+constexpr unsigned FLUSH = 1u << 0;
+constexpr unsigned STRAIGHT = 1u << 1;
+constexpr unsigned ROYAL_SPAN = 1u << 2;  // 最小点数为 10 且最大点数为 A
+constexpr unsigned HAS_FOUR = 1u << 3;
+constexpr unsigned HAS_THREE = 1u << 4;
+constexpr unsigned PAIR_SHIFT = 5;        // 对子数，2 位并截断到 2
+constexpr unsigned COUNT = 1u << 7;
+} // namespace HandClassKey
+
+enum class ScoringRule : std::uint8_t {
+    AllCards,
+    RanksOfTwo,
+    RanksOfThree,
+    RanksOfFour,
+    HighestCard
+};
+
+struct HandClassEntry {
+    PokerHandType type = PokerHandType::HighCard;
+    ScoringRule rule = ScoringRule::HighestCard;
+};
+
+/**
+ * 按分类键执行牌型判定树。
+ *
+ * 仅在编译期用于生成分类表，运行期只做一次查表。
+ *
+ * @param key 分类键
+ * @return 牌型与计分规则
+ */
+constexpr HandClassEntry classifyKey(unsigned key) {
+    const bool flush = key & HandClassKey::FLUSH;
+    const bool straight = key & HandClassKey::STRAIGHT;
+    const bool royalSpan = key & HandClassKey::ROYAL_SPAN;
+    const bool four = key & HandClassKey::HAS_FOUR;
+    const bool three = key & HandClassKey::HAS_THREE;
+    const unsigned pairs = (key >> HandClassKey::PAIR_SHIFT) & 3u;
+
+    // 判定顺序按牌型强度从高到低，防止弱牌型提前命中。
+    if (straight && flush) {
+        // 皇家同花顺需要 10 起始且 A 结尾。
+        return {royalSpan ? PokerHandType::RoyalFlush : PokerHandType::StraightFlush, ScoringRule::AllCards};
+    }
+    // 仅保留参与得分的四张同点牌。
+    if (four) return {PokerHandType::FourOfAKind, ScoringRule::RanksOfFour};
+    if (three && pairs > 0) return {PokerHandType::FullHouse, ScoringRule::AllCards};
+    if (flush) return {PokerHandType::Flush, ScoringRule::AllCards};
+    if (straight) return {PokerHandType::Straight, ScoringRule::AllCards};
+    if (three) return {PokerHandType::ThreeOfAKind, ScoringRule::RanksOfThree};
+    if (pairs >= 2) return {PokerHandType::TwoPair, ScoringRule::RanksOfTwo};
+    if (pairs == 1) return {PokerHandType::Pair, ScoringRule::RanksOfTwo};
+    // 高牌仅保留最大点数作为计分牌。
+    return {PokerHandType::HighCard, ScoringRule::HighestCard};
+}
+
+// 分类表在编译期生成并随可执行文件一同加载，启动期无需重建。
+constexpr auto HAND_CLASS_TABLE = [] {
+    std::array<HandClassEntry, HandClassKey::COUNT> table{};
+    for (unsigned key = 0; key < HandClassKey::COUNT; ++key) {
+        table[key] = classifyKey(key);
+    }
+    return table;
+}();
+
+#if BALATRO_HAND_AVX2
+bool cpuHasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+// 以下为 ranksWithCount 等标量位技巧的 4 通道版本。
+__attribute__((target("avx2"))) inline __m256i slotsWithCount(__m256i counts, long long k) {
+    __m256i x = _mm256_xor_si256(counts, _mm256_set1_epi64x(static_cast<long long>(RANK_NIBBLE_LSB) * k));
+    x = _mm256_or_si256(x, _mm256_srli_epi64(x, 1));
+    x = _mm256_or_si256(x, _mm256_srli_epi64(x, 2));
+    return _mm256_andnot_si256(x, _mm256_set1_epi64x(static_cast<long long>(RANK_NIBBLE_LSB)));
+}
+
+__attribute__((target("avx2"))) inline __m256i isZero(__m256i v) {
+    return _mm256_cmpeq_epi64(v, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2"))) inline __m256i isNonZero(__m256i v) {
+    return _mm256_xor_si256(isZero(v), _mm256_set1_epi64x(-1));
+}
+
+__attribute__((target("avx2"))) inline __m256i equals(__m256i v, long long bits) {
+    return _mm256_cmpeq_epi64(v, _mm256_set1_epi64x(bits));
+}
+
+__attribute__((target("avx2"))) inline __m256i maskedBits(__m256i lanes, unsigned bit) {
+    return _mm256_and_si256(lanes, _mm256_set1_epi64x(bit));
+}
+
+/**
+ * AVX2 批量计算分类键。
+ *
+ * 每 4 手牌转置为结构数组：点数计数、点数掩码、花色计数、张数各占一个
+ * 256 bit 寄存器，按 64 bit 通道并行算出与 HandEvaluator::classKey
+ * 完全一致的特征位；顺子改用“最低连续段”位技巧，无需查表。
+ *
+ * @param hands 输入手牌
+ * @param keys 输出分类键
+ * @param count 手牌数
+ * @return 已处理的手牌数（4 的整数倍），剩余部分由调用方走标量路径
+ */
+__attribute__((target("avx2")))
+std::size_t classKeysAvx2(const PackedHand* hands, unsigned* keys, std::size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i nibbleHigh = _mm256_set1_epi64x(static_cast<long long>(RANK_NIBBLE_LSB * 0xE));
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i four = _mm256_set1_epi64x(4);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const PackedHand* h = hands + i;
+        const __m256i counts = _mm256_set_epi64x(
+            static_cast<long long>(h[3].rank_counts), static_cast<long long>(h[2].rank_counts),
+            static_cast<long long>(h[1].rank_counts), static_cast<long long>(h[0].rank_counts));
+        const __m256i ranks = _mm256_set_epi64x(h[3].rank_mask, h[2].rank_mask, h[1].rank_mask, h[0].rank_mask);
+        const __m256i suits = _mm256_set_epi64x(h[3].suit_counts, h[2].suit_counts, h[1].suit_counts, h[0].suit_counts);
+        const __m256i sizes = _mm256_set_epi64x(h[3].size, h[2].size, h[1].size, h[0].size);
+
+        const __m256i pairSlots = slotsWithCount(counts, 2);
+        const __m256i hasThree = isNonZero(slotsWithCount(counts, 3));
+        const __m256i hasFour = isNonZero(slotsWithCount(counts, 4));
+        const __m256i pairsAtLeast1 = isNonZero(pairSlots);
+        const __m256i pairsAtLeast2 = isNonZero(_mm256_and_si256(pairSlots, _mm256_sub_epi64(pairSlots, one)));
+
+        // 同花：至少 5 张且只有一个花色槽非零。
+        const __m256i atLeast5 = _mm256_cmpgt_epi64(sizes, four);
+        __m256i suitNz = _mm256_or_si256(suits, _mm256_srli_epi64(suits, 1));
+        suitNz = _mm256_or_si256(suitNz, _mm256_srli_epi64(suitNz, 2));
+        suitNz = _mm256_and_si256(suitNz, _mm256_set1_epi64x(0x11111));
+        const __m256i singleSuit = isZero(_mm256_and_si256(suitNz, _mm256_sub_epi64(suitNz, one)));
+        const __m256i flush = _mm256_and_si256(atLeast5, singleSuit);
+
+        // 顺子：无重复点数时要求掩码为单个连续段或含 A-2-3-4-5；
+        // 有重复点数时只可能命中低 A 顺子。
+        const __m256i noDuplicate = isZero(_mm256_and_si256(counts, nibbleHigh));
+        const __m256i lowest = _mm256_and_si256(ranks, _mm256_sub_epi64(zero, ranks));
+        const __m256i contiguous = isZero(_mm256_and_si256(_mm256_add_epi64(ranks, lowest), ranks));
+        const long long wheel = (1LL << rankBit(Rank::Ace)) | 0xF;
+        const __m256i wheelRanks = equals(_mm256_and_si256(ranks, _mm256_set1_epi64x(wheel)), wheel);
+        const long long aceSlot = 0xFLL << (4 * rankBit(Rank::Ace));
+        const __m256i duplicateWheel = _mm256_and_si256(
+            equals(_mm256_and_si256(counts, _mm256_set1_epi64x(0xFFF)), 0x111),
+            _mm256_and_si256(isNonZero(_mm256_and_si256(counts, _mm256_set1_epi64x(0xF000))),
+                             isNonZero(_mm256_and_si256(counts, _mm256_set1_epi64x(aceSlot)))));
+        const __m256i straight = _mm256_and_si256(atLeast5, _mm256_or_si256(
+            _mm256_and_si256(noDuplicate, _mm256_or_si256(contiguous, wheelRanks)), duplicateWheel));
+
+        const long long royalBits = (1LL << rankBit(Rank::Ten)) | (1LL << rankBit(Rank::Ace));
+        const __m256i royalSpan = equals(_mm256_and_si256(ranks, _mm256_set1_epi64x(royalBits | 0xFF)), royalBits);
+
+        __m256i key = maskedBits(flush, HandClassKey::FLUSH);
+        key = _mm256_or_si256(key, maskedBits(straight, HandClassKey::STRAIGHT));
+        key = _mm256_or_si256(key, maskedBits(royalSpan, HandClassKey::ROYAL_SPAN));
+        key = _mm256_or_si256(key, maskedBits(hasFour, HandClassKey::HAS_FOUR));
+        key = _mm256_or_si256(key, maskedBits(hasThree, HandClassKey::HAS_THREE));
+        key = _mm256_add_epi64(key, maskedBits(pairsAtLeast1, 1u << HandClassKey::PAIR_SHIFT));
+        key = _mm256_add_epi64(key, maskedBits(pairsAtLeast2, 1u << HandClassKey::PAIR_SHIFT));
+
+        alignas(32) std::uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), key);
+        for (int k = 0; k < 4; ++k) keys[i + k] = static_cast<unsigned>(lanes[k]);
+    }
+    return i;
+}
+#endif
+
+// 牌型名称驻留表，按 PokerHandType 顺序排列。
+constexpr std::array<std::string_view, 13> HAND_NAMES = {
+    "High Card",
+    "Pair",
+    "Two Pair",
+    "3 of a Kind",
+    "Straight",
+    "Flush",
+    "Full House",
+    "4 of a Kind",
+    "Straight Flush",
+    "Royal Flush",
+    "5 of a Kind",
+    "Flush Five",
+    "Flush House",
 };
 
-HandResult HandEvaluator::Evaluate(const std::vector<CardSnapshot>& hand) {
+} // namespace
+
+HandResult HandEvaluator::Evaluate(std::span<const CardSnapshot> hand) {
     HandResult result;
-    result.scoring_snapshots = hand;
-    
+
     if (hand.empty()) {
         result.type = PokerHandType::HighCard;
-        result.name = "High Card";
+        result.name = GetHandName(PokerHandType::HighCard);
         result.base_chips = 0;
         result.base_mult = 0;
         return result;
     }
 
-    // 先排序是为了把顺子判定和高牌选择简化为线性扫描。
-    std::vector<CardSnapshot> sorted = hand;
-    std::sort(sorted.begin(), sorted.end(), [](const CardSnapshot& a, const CardSnapshot& b) {
-        return a.rank < b.rank;
-    });
-
-    // 频次统计是为了让对子/三条/四条判定保持 O(n)。
-    std::map<Rank, int> rank_counts;
-    std::map<Suit, int> suit_counts;
-    for (const auto& c : sorted) {
-        rank_counts[c.rank]++;
-        suit_counts[c.suit]++;
+    assert(hand.size() <= static_cast<std::size_t>(MAX_PLAY_CARDS));
+    const HandClass cls = Classify(Pack(hand));
+    result.type = cls.type;
+    result.name = GetHandName(cls.type);
+
+    // 按输入顺序回填计分牌，保持与效果链路约定的出牌顺序一致。
+    for (std::uint16_t m = cls.scoring_mask; m != 0; m &= m - 1) {
+        result.scoring_snapshots.push_back(hand[std::countr_zero(m)]);
     }
 
-    // 先算组合特征再走判定树，能避免重复遍历。
-    bool flush = isFlush(sorted);
-    bool straight = isStraight(sorted);
-    
-    // 记录重复分布用于牌型分类。
-    int max_count = 0;
-    int pair_count = 0;
-    int three_count = 0;
-    int four_count = 0;
-
-    for (auto const& [rank, count] : rank_counts) {
-        if (count > max_count) max_count = count;
-        if (count == 2) pair_count++;
-        if (count == 3) three_count++;
-        if (count == 4) four_count++;
+    // 基础值在统一出口填充，避免分支重复写入。
+    const BaseStats& stats = BASE_STATS[static_cast<std::size_t>(result.type)];
+    result.base_chips = stats.chips;
+    result.base_mult = stats.mult;
+
+    return result;
+}
+
+BaseStats HandEvaluator::GetBaseStats(PokerHandType type) {
+    return BASE_STATS[static_cast<std::size_t>(type)];
+}
+
+std::string_view HandEvaluator::GetHandName(PokerHandType type) {
+    return HAND_NAMES[static_cast<std::size_t>(type)];
+}
+
+PackedHand HandEvaluator::Pack(std::span<const CardSnapshot> hand) {
+    PackedHand packed;
+    const std::size_t n = std::min(hand.size(), static_cast<std::size_t>(PackedHand::MAX_CARDS));
+    for (std::size_t i = 0; i < n; ++i) {
+        packed.add(static_cast<int>(i), hand[i].suit, hand[i].rank);
     }
+    return packed;
+}
 
-    // 判定顺序按牌型强度从高到低，防止弱牌型提前命中。
-    if (straight && flush) {
-        // 皇家同花顺需要 10 起始且 A 结尾。
-        if (sorted.back().rank == Rank::Ace && sorted.front().rank == Rank::Ten) {
-             result.type = PokerHandType::RoyalFlush;
-             result.name = "Royal Flush";
-        } else {
-             result.type = PokerHandType::StraightFlush;
-             result.name = "Straight Flush";
+HandClass HandEvaluator::Classify(const PackedHand& packed) {
+    if (packed.size == 0) return HandClass{};
+    return resolveClass(packed, classKey(packed));
+}
+
+void HandEvaluator::EvaluateBatch(std::span<const PackedHand> hands, std::span<HandClass> out) {
+    assert(out.size() >= hands.size());
+    const std::size_t count = std::min(hands.size(), out.size());
+
+    // 分块计算分类键，键缓冲放在栈上以保持整个批处理无堆分配。
+    constexpr std::size_t CHUNK = 256;
+    unsigned keys[CHUNK];
+    for (std::size_t base = 0; base < count; base += CHUNK) {
+        const std::size_t n = std::min(CHUNK, count - base);
+        const PackedHand* chunk = hands.data() + base;
+
+        std::size_t done = 0;
+#if BALATRO_HAND_AVX2
+        if (cpuHasAvx2()) {
+            done = classKeysAvx2(chunk, keys, n);
         }
-    }
-    else if (four_count > 0) {
-        result.type = PokerHandType::FourOfAKind;
-        result.name = "4 of a Kind";
-        // 仅保留参与得分的四张同点牌。
-        result.scoring_snapshots.clear();
-        for (const auto& c : hand) {
-            if (rank_counts[c.rank] == 4) {
-                result.scoring_snapshots.push_back(c);
-            }
+#endif
+        for (std::size_t i = done; i < n; ++i) {
+            keys[i] = classKey(chunk[i]);
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            out[base + i] = chunk[i].size == 0 ? HandClass{} : resolveClass(chunk[i], keys[i]);
         }
     }
-    else if (three_count > 0 && pair_count > 0) {
-        result.type = PokerHandType::FullHouse;
-        result.name = "Full House";
-    }
-    else if (flush) {
-        result.type = PokerHandType::Flush;
-        result.name = "Flush";
-    }
-    else if (straight) {
-        result.type = PokerHandType::Straight;
-        result.name = "Straight";
+}
+
+std::vector<PlayCandidate> HandEvaluator::EnumerateBestPlays(
+    std::span<const CardSnapshot> hand,
+    const EffectPipeline* jokers,
+    std::size_t topK
+) {
+    std::vector<PlayCandidate> candidates;
+    EnumerateBestPlays(hand, jokers, topK, candidates);
+    return candidates;
+}
+
+void HandEvaluator::EnumerateBestPlays(
+    std::span<const CardSnapshot> hand,
+    const EffectPipeline* jokers,
+    std::size_t topK,
+    std::vector<PlayCandidate>& candidates
+) {
+    candidates.clear();
+    const int n = std::min(static_cast<int>(hand.size()), PackedHand::MAX_CARDS);
+    if (n == 0 || topK == 0) return;
+
+    // 预先写好每个位置的点数槽，后续增删只改计数与成员掩码。
+    PackedHand packed = Pack(hand.first(static_cast<std::size_t>(n)));
+    for (int i = 0; i < n; ++i) {
+        packed.remove(i, hand[i].suit, hand[i].rank);
     }
-    else if (three_count > 0) {
-        result.type = PokerHandType::ThreeOfAKind;
-        result.name = "3 of a Kind";
-        result.scoring_snapshots.clear();
-        for (const auto& c : hand) {
-            if (rank_counts[c.rank] == 3) {
-                result.scoring_snapshots.push_back(c);
-            }
+
+    // 快照缓冲内联在栈上并跨子集复用，枚举过程只为结果列表分配。
+    ScoringSnapshots scoring;
+    FixedVector<CardSnapshot, PackedHand::MAX_CARDS> held;
+
+    const std::uint32_t subsetCount = 1u << n;
+    for (std::uint32_t step = 1; step < subsetCount; ++step) {
+        // 第 step 个格雷码与前一个只差最低置位对应的那张牌。
+        const int flip = std::countr_zero(step);
+        if ((packed.members >> flip) & 1) {
+            packed.remove(flip, hand[flip].suit, hand[flip].rank);
+        } else {
+            packed.add(flip, hand[flip].suit, hand[flip].rank);
         }
-    }
-    else if (pair_count >= 2) {
-        result.type = PokerHandType::TwoPair;
-        result.name = "Two Pair";
-        result.scoring_snapshots.clear();
-        for (const auto& c : hand) {
-            if (rank_counts[c.rank] == 2) {
-                result.scoring_snapshots.push_back(c);
-            }
+        if (packed.size > MAX_PLAY_CARDS) continue;
+
+        const HandClass cls = Classify(packed);
+        scoring.clear();
+        for (std::uint16_t m = cls.scoring_mask; m != 0; m &= m - 1) {
+            scoring.push_back(hand[std::countr_zero(m)]);
         }
-    }
-    else if (pair_count == 1) {
-        result.type = PokerHandType::Pair;
-        result.name = "Pair";
-        result.scoring_snapshots.clear();
-        for (const auto& c : hand) {
-            if (rank_counts[c.rank] == 2) {
-                result.scoring_snapshots.push_back(c);
-            }
+        held.clear();
+        for (int i = 0; i < n; ++i) {
+            if (!((packed.members >> i) & 1)) held.push_back(hand[i]);
         }
+
+        const BaseStats& stats = BASE_STATS[static_cast<std::size_t>(cls.type)];
+        const ScoreSummary summary = ScoringManager::CalculateFinalScore(
+            stats.chips, stats.mult, scoring, held, jokers
+        );
+
+        PlayCandidate candidate;
+        candidate.card_mask = packed.members;
+        candidate.type = cls.type;
+        candidate.final_chips = summary.final_chips;
+        candidate.final_mult = summary.final_mult;
+        candidate.final_score = summary.final_score;
+        candidates.push_back(candidate);
     }
-    else {
-        result.type = PokerHandType::HighCard;
-        result.name = "High Card";
-        // 高牌仅保留最大点数作为计分牌。
-        result.scoring_snapshots.clear();
-        if (!sorted.empty()) {
-            result.scoring_snapshots.push_back(sorted.back());
+
+    // 同分时优先少出牌，再按位置稳定排序，保证提示结果可复现。
+    const auto better = [](const PlayCandidate& a, const PlayCandidate& b) {
+        if (a.final_score != b.final_score) return a.final_score > b.final_score;
+        const int aCards = std::popcount(a.card_mask);
+        const int bCards = std::popcount(b.card_mask);
+        if (aCards != bCards) return aCards < bCards;
+        return a.card_mask < b.card_mask;
+    };
+    const std::size_t keep = std::min(topK, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(keep), candidates.end(), better);
+    candidates.resize(keep);
+}
+
+unsigned HandEvaluator::classKey(const PackedHand& packed) {
+    // 先算组合特征再查表，能避免重复遍历和多层分支。
+    const std::uint64_t pairSlots = ranksWithCount(packed.rank_counts, 2);
+    const std::uint8_t pattern = RANK_PATTERN_TABLE[packed.rank_mask];
+    const int pairCount = std::popcount(pairSlots);
+
+    return (isFlush(packed) ? HandClassKey::FLUSH : 0u) |
+           (isStraight(packed) ? HandClassKey::STRAIGHT : 0u) |
+           ((pattern & RankPattern::ROYAL_SPAN) ? HandClassKey::ROYAL_SPAN : 0u) |
+           (ranksWithCount(packed.rank_counts, 4) ? HandClassKey::HAS_FOUR : 0u) |
+           (ranksWithCount(packed.rank_counts, 3) ? HandClassKey::HAS_THREE : 0u) |
+           (static_cast<unsigned>(std::min(pairCount, 2)) << HandClassKey::PAIR_SHIFT);
+}
+
+HandClass HandEvaluator::resolveClass(const PackedHand& packed, unsigned key) {
+    HandClass cls;
+    const HandClassEntry entry = HAND_CLASS_TABLE[key];
+    cls.type = entry.type;
+
+    switch (entry.rule) {
+        case ScoringRule::AllCards:
+            cls.scoring_mask = packed.members;
+            break;
+        case ScoringRule::RanksOfTwo:
+            cls.scoring_mask = positionsOfRanks(packed, ranksWithCount(packed.rank_counts, 2));
+            break;
+        case ScoringRule::RanksOfThree:
+            cls.scoring_mask = positionsOfRanks(packed, ranksWithCount(packed.rank_counts, 3));
+            break;
+        case ScoringRule::RanksOfFour:
+            cls.scoring_mask = positionsOfRanks(packed, ranksWithCount(packed.rank_counts, 4));
+            break;
+        case ScoringRule::HighestCard: {
+            const int top = RANK_PATTERN_TABLE[packed.rank_mask] & RankPattern::TOP_RANK;
+            const std::uint16_t topPositions =
+                positionsOfRanks(packed, std::uint64_t{1} << (4 * top));
+            cls.scoring_mask = topPositions & static_cast<std::uint16_t>(-topPositions);
+            break;
         }
     }
 
-    // 基础值在统一出口填充，避免分支重复写入。
-    if (BASE_STATS.count(result.type)) {
-        result.base_chips = BASE_STATS.at(result.type).first;
-        result.base_mult = BASE_STATS.at(result.type).second;
-    }
+    return cls;
+}
 
-    return result;
+bool HandEvaluator::isFlush(const PackedHand& packed) {
+    if (packed.size < 5) return false;
+    // 同花等价于仅有一个花色槽非零，且该槽计数等于总张数。
+    const int slot = std::countr_zero(packed.suit_counts) & ~3;
+    return packed.suit_counts == (static_cast<std::uint32_t>(packed.size) << slot);
 }
 
-bool HandEvaluator::isFlush(const std::vector<CardSnapshot>& hand) {
-    if (hand.size() < 5) return false;
-    Suit firstSuit = hand[0].suit;
-    for (const auto& c : hand) {
-        if (c.suit != firstSuit) return false;
-    }
-    return true;
-}
-
-bool HandEvaluator::isStraight(const std::vector<CardSnapshot>& hand) {
-    if (hand.size() < 5) return false;
-    // 处理 A-2-3-4-5 的低 A 顺子，保证规则与扑克牌习惯一致。
-    bool lowAceStraight = (hand.back().rank == Rank::Ace &&
-                           hand[0].rank == Rank::Two &&
-                           hand[1].rank == Rank::Three &&
-                           hand[2].rank == Rank::Four &&
-                           hand[3].rank == Rank::Five);
-    if (lowAceStraight) return true;
-
-    // 常规顺子要求相邻点数差为 1。
-    for (size_t i = 0; i < hand.size() - 1; ++i) {
-        int diff = static_cast<int>(hand[i + 1].rank) - static_cast<int>(hand[i].rank);
-        if (diff != 1) return false;
+bool HandEvaluator::isStraight(const PackedHand& packed) {
+    if (packed.size < 5) return false;
+
+    // 点数互不重复时顺子（含低 A 顺子）完全由点数掩码决定。
+    if (std::popcount(packed.rank_mask) == packed.size) {
+        return RANK_PATTERN_TABLE[packed.rank_mask] & RankPattern::STRAIGHT;
     }
-    return true;
+
+    // 带重复点数时只可能命中低 A 顺子：最小四张依次为 2/3/4/5 且最大为 A。
+    const std::uint64_t counts = packed.rank_counts;
+    return (counts & 0xFFF) == 0x111 &&
+           (counts & 0xF000) != 0 &&
+           ((counts >> (4 * rankBit(Rank::Ace))) & 0xF) != 0;
 }
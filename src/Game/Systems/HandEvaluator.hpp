@@ -1,8 +1,12 @@
 #pragma once
+#include <cstdint>
+#include <span>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <map>
 #include <algorithm>
+#include "../Core/FixedVector.hpp"
 #include "../Objects/CardModel.hpp"
 #include "CardSnapshot.hpp"
 
@@ -28,43 +32,239 @@ enum class PokerHandType {
     FlushHouse
 };
 
+// 单次出牌最多 5 张，计分牌数量不会超过该上限。
+using ScoringSnapshots = FixedVector<CardSnapshot, 5>;
+
+/**
+ * 牌型基础筹码与倍率。
+ */
+struct BaseStats {
+    int chips = 0;
+    int mult = 0;
+};
+
 /**
  * 牌型评估结果。
+ *
+ * 名称指向静态驻留表、计分快照内联存放，
+ * 因此每帧预览与批量评估都不会产生堆分配。
  */
 struct HandResult {
-    PokerHandType type;
-    std::string name;
-    int base_chips;
-    int base_mult;
+    PokerHandType type = PokerHandType::HighCard;
+    std::string_view name;
+    int base_chips = 0;
+    int base_mult = 0;
 
     // 计分快照用于后续效果链路，避免直接传递渲染对象。
-    std::vector<CardSnapshot> scoring_snapshots;
+    ScoringSnapshots scoring_snapshots;
+};
+
+/**
+ * 手牌位编码。
+ *
+ * 以点数位掩码与 4 bit 计数槽描述一手牌，使牌型分类只依赖位运算，
+ * 不再需要排序和关联容器，整个分类过程不产生堆分配。
+ */
+struct PackedHand {
+    // 计数槽宽 4 bit，单手牌张数不能超过槽位上限。
+    static constexpr int MAX_CARDS = 15;
+
+    std::uint16_t rank_mask = 0;    // 第 (rank - 2) 位表示该点数出现
+    std::uint64_t rank_counts = 0;  // 每个点数占 4 bit，记录出现次数
+    std::uint64_t card_ranks = 0;   // 按输入位置每张牌占 4 bit，记录 (rank - 2)
+    std::uint32_t suit_counts = 0;  // 每个花色（含 Suit::None）占 4 bit
+    std::uint16_t members = 0;      // 当前参与评估的输入位置
+    std::uint8_t size = 0;
+
+    /**
+     * 将输入位置上的牌加入编码。
+     *
+     * 增删都是常数时间，枚举子集时可沿格雷码顺序逐张增量更新。
+     *
+     * @param position 输入位置
+     * @param suit 花色
+     * @param rank 点数
+     */
+    void add(int position, Suit suit, Rank rank) {
+        const int r = static_cast<int>(rank) - static_cast<int>(Rank::Two);
+        rank_mask |= static_cast<std::uint16_t>(1u << r);
+        rank_counts += std::uint64_t{1} << (4 * r);
+        card_ranks = (card_ranks & ~(std::uint64_t{0xF} << (4 * position))) |
+                     (static_cast<std::uint64_t>(r) << (4 * position));
+        suit_counts += 1u << (4 * static_cast<int>(suit));
+        members |= static_cast<std::uint16_t>(1u << position);
+        ++size;
+    }
+
+    /**
+     * 将输入位置上的牌移出编码。
+     *
+     * @param position 输入位置
+     * @param suit 花色
+     * @param rank 点数
+     */
+    void remove(int position, Suit suit, Rank rank) {
+        const int r = static_cast<int>(rank) - static_cast<int>(Rank::Two);
+        rank_counts -= std::uint64_t{1} << (4 * r);
+        if (((rank_counts >> (4 * r)) & 0xF) == 0) {
+            rank_mask &= static_cast<std::uint16_t>(~(1u << r));
+        }
+        suit_counts -= 1u << (4 * static_cast<int>(suit));
+        members &= static_cast<std::uint16_t>(~(1u << position));
+        --size;
+    }
+};
+
+class EffectPipeline;
+
+/**
+ * 牌型分类结果。
+ *
+ * 计分牌以输入位置掩码表示，调用方按需回填快照，
+ * 避免分类阶段复制牌数据。
+ */
+struct HandClass {
+    PokerHandType type = PokerHandType::HighCard;
+    std::uint16_t scoring_mask = 0;  // 第 i 位表示输入中第 i 张牌参与计分
+};
+
+/**
+ * 候选出牌方案。
+ */
+struct PlayCandidate {
+    std::uint16_t card_mask = 0;  // 第 i 位表示出第 i 张手牌
+    PokerHandType type = PokerHandType::HighCard;
+    int final_chips = 0;
+    int final_mult = 0;
+    long long final_score = 0;
 };
 
 class HandEvaluator {
 public:
+    // 单次出牌张数上限，与选牌交互保持一致。
+    static constexpr int MAX_PLAY_CARDS = static_cast<int>(ScoringSnapshots::capacity());
+
     /**
      * 评估输入手牌并返回计分基础值。
      *
-     * @param hand 手牌快照
+     * @param hand 手牌快照，最多 MAX_PLAY_CARDS 张
      * @return 评估结果
      */
-    static HandResult Evaluate(const std::vector<CardSnapshot>& hand);
+    static HandResult Evaluate(std::span<const CardSnapshot> hand);
+
+    /**
+     * 查询牌型展示名称。
+     *
+     * @param type 牌型
+     * @return 指向静态驻留表的名称
+     */
+    static std::string_view GetHandName(PokerHandType type);
+
+    /**
+     * 查询牌型基础筹码与倍率。
+     *
+     * @param type 牌型
+     * @return 基础值
+     */
+    static BaseStats GetBaseStats(PokerHandType type);
+
+    /**
+     * 将手牌编码为位表示。
+     *
+     * 超过 PackedHand::MAX_CARDS 的部分会被忽略。
+     *
+     * @param hand 手牌快照
+     * @return 位编码手牌
+     */
+    static PackedHand Pack(std::span<const CardSnapshot> hand);
+
+    /**
+     * 对位编码手牌分类。
+     *
+     * 仅使用位运算完成，不产生堆分配，适合高频调用。
+     *
+     * @param packed 位编码手牌
+     * @return 牌型与计分位置
+     */
+    static HandClass Classify(const PackedHand& packed);
+
+    /**
+     * 批量分类位编码手牌。
+     *
+     * 面向模拟场景：支持 AVX2 的 x86-64 CPU 上按 4 手一组并行计算分类特征，
+     * 其余平台回退到标量路径，两条路径与 Classify 结果逐项一致。
+     *
+     * @param hands 输入手牌
+     * @param out 输出分类结果，长度不得小于 hands
+     */
+    static void EvaluateBatch(std::span<const PackedHand> hands, std::span<HandClass> out);
+
+    /**
+     * 枚举手牌的全部合法出牌并返回得分最高的若干方案。
+     *
+     * 子集按格雷码顺序遍历，每步只增删一张牌，点数/花色计数可增量复用；
+     * 每个 1~5 张的子集都会走完整的 ScoringManager Joker 结算链路，
+     * 未出的牌按“手持牌”参与 HeldInHand 阶段。
+     *
+     * @param hand 当前手牌快照
+     * @param jokers Joker 效果流水线，可为空
+     * @param topK 返回方案数上限
+     * @return 按最终得分降序排列的方案
+     */
+    static std::vector<PlayCandidate> EnumerateBestPlays(
+        std::span<const CardSnapshot> hand,
+        const EffectPipeline* jokers,
+        std::size_t topK
+    );
+
+    /**
+     * 同上，结果写入调用方持有的缓冲，复用其容量。
+     *
+     * 供搜索在每个节点反复枚举时使用，缓冲容量稳定后不再分配。
+     *
+     * @param hand 当前手牌快照
+     * @param jokers Joker 效果流水线，可为空
+     * @param topK 返回方案数上限
+     * @param out 输出方案，原有内容被覆盖
+     */
+    static void EnumerateBestPlays(
+        std::span<const CardSnapshot> hand,
+        const EffectPipeline* jokers,
+        std::size_t topK,
+        std::vector<PlayCandidate>& out
+    );
 
 private:
+    /**
+     * 计算分类表索引。
+     *
+     * @param packed 位编码手牌
+     * @return 分类键
+     */
+    static unsigned classKey(const PackedHand& packed);
+
+    /**
+     * 按分类键查表并解析计分位置。
+     *
+     * @param packed 位编码手牌
+     * @param key 分类键
+     * @return 牌型与计分位置
+     */
+    static HandClass resolveClass(const PackedHand& packed, unsigned key);
+
     /**
      * 判断是否同花。
      *
-     * @param hand 手牌快照
+     * @param packed 位编码手牌
      * @return 是否同花
      */
-    static bool isFlush(const std::vector<CardSnapshot>& hand);
+    static bool isFlush(const PackedHand& packed);
 
     /**
      * 判断是否顺子。
      *
-     * @param hand 手牌快照
+     * @param packed 位编码手牌
      * @return 是否顺子
      */
-    static bool isStraight(const std::vector<CardSnapshot>& hand);
+    static bool isStraight(const PackedHand& packed);
 };
@@ -1,18 +1,21 @@
 #include "JokerEffectFactory.hpp"
 
+#include <algorithm>
+#include <optional>
+
 #include "../Effects/JokerEffects.hpp"
-#include "../Objects/Card.hpp"
 
 namespace {
 
-Suit parseSuit(const std::string& suitStr) {
+std::optional<Suit> findSuit(const std::string& suitStr) {
+    if (suitStr == "Spades") return Suit::Spades;
     if (suitStr == "Hearts") return Suit::Hearts;
     if (suitStr == "Clubs") return Suit::Clubs;
     if (suitStr == "Diamonds") return Suit::Diamonds;
-    return Suit::Spades;
+    return std::nullopt;
 }
 
-Rank parseRank(const std::string& rankStr) {
+std::optional<Rank> findRank(const std::string& rankStr) {
     if (rankStr == "2") return Rank::Two;
     if (rankStr == "3") return Rank::Three;
     if (rankStr == "4") return Rank::Four;
@@ -25,7 +28,124 @@ Rank parseRank(const std::string& rankStr) {
     if (rankStr == "Jack") return Rank::Jack;
     if (rankStr == "Queen") return Rank::Queen;
     if (rankStr == "King") return Rank::King;
-    return Rank::Ace;
+    if (rankStr == "Ace") return Rank::Ace;
+    return std::nullopt;
+}
+
+std::optional<TriggerType> findTrigger(const std::string& triggerStr) {
+    if (triggerStr == "Individual") return TriggerType::Individual;
+    if (triggerStr == "HeldInHand") return TriggerType::HeldInHand;
+    if (triggerStr == "Global") return TriggerType::Global;
+    if (triggerStr == "OnDiscard") return TriggerType::OnDiscard;
+    return std::nullopt;
+}
+
+Suit parseSuit(const std::string& suitStr) {
+    return findSuit(suitStr).value_or(Suit::Spades);
+}
+
+Rank parseRank(const std::string& rankStr) {
+    return findRank(rankStr).value_or(Rank::Ace);
+}
+
+bool compileTriggers(const nlohmann::json& node, JokerProgram& program, std::string& error) {
+    const auto addTrigger = [&](const nlohmann::json& item) {
+        if (!item.is_string()) return false;
+        const auto trigger = findTrigger(item.get<std::string>());
+        if (!trigger) return false;
+        program.triggers |= TriggerBit(*trigger);
+        return true;
+    };
+
+    bool ok = node.is_array() ? std::all_of(node.begin(), node.end(), addTrigger) : addTrigger(node);
+    if (!ok || program.triggers == 0) {
+        error = "invalid trigger: " + node.dump();
+        return false;
+    }
+    return true;
+}
+
+bool compileWhen(const nlohmann::json& node, JokerProgram& program, std::string& error) {
+    if (!node.is_object()) {
+        error = "\"when\" must be an object";
+        return false;
+    }
+
+    for (const auto& [key, value] : node.items()) {
+        if (key == "suit") {
+            const auto suit = value.is_string() ? findSuit(value.get<std::string>()) : std::nullopt;
+            if (!suit) {
+                error = "invalid suit: " + value.dump();
+                return false;
+            }
+            program.ops.push_back({.code = JokerOpCode::RequireSuit, .value = static_cast<int>(*suit)});
+        } else if (key == "rank") {
+            int mask = 0;
+            const nlohmann::json ranks = value.is_array() ? value : nlohmann::json::array({value});
+            for (const auto& item : ranks) {
+                const auto rank = item.is_string() ? findRank(item.get<std::string>()) : std::nullopt;
+                if (!rank) {
+                    error = "invalid rank: " + item.dump();
+                    return false;
+                }
+                mask |= 1 << (static_cast<int>(*rank) - static_cast<int>(Rank::Two));
+            }
+            program.ops.push_back({.code = JokerOpCode::RequireRankMask, .value = mask});
+        } else if (key == "scoring_at_least" || key == "scoring_at_most") {
+            if (!value.is_number_integer()) {
+                error = "condition \"" + key + "\" expects an integer";
+                return false;
+            }
+            const JokerOpCode code = key == "scoring_at_least" ? JokerOpCode::RequireScoringAtLeast
+                                                               : JokerOpCode::RequireScoringAtMost;
+            program.ops.push_back({.code = code, .value = value.get<int>()});
+        } else {
+            error = "unsupported condition: " + key;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool compileDo(const nlohmann::json& node, JokerProgram& program, std::string& error) {
+    if (!node.is_object() || node.empty()) {
+        error = "\"do\" must be a non-empty object";
+        return false;
+    }
+
+    // 缩放指令必须先于加法动作，因此单独提前处理。
+    if (node.contains("per_joker")) {
+        const nlohmann::json& perJoker = node["per_joker"];
+        if (!perJoker.is_boolean()) {
+            error = "\"per_joker\" expects a boolean";
+            return false;
+        }
+        if (perJoker.get<bool>()) program.ops.push_back({.code = JokerOpCode::ScaleByJokers});
+    }
+
+    for (const auto& [key, value] : node.items()) {
+        if (key == "per_joker") continue;
+        if (key == "xmult" && value.is_number()) {
+            program.ops.push_back({.code = JokerOpCode::MulMult, .factor = value.get<float>()});
+            continue;
+        }
+        if (!value.is_number_integer()) {
+            error = "action \"" + key + "\" expects an integer";
+            return false;
+        }
+        const int amount = value.get<int>();
+        if (key == "chips") {
+            program.ops.push_back({.code = JokerOpCode::AddChips, .value = amount});
+        } else if (key == "mult") {
+            program.ops.push_back({.code = JokerOpCode::AddMult, .value = amount});
+        } else if (key == "dollars") {
+            program.ops.push_back({.code = JokerOpCode::AddDollars, .value = amount});
+        } else {
+            error = "unsupported action: " + key;
+            return false;
+        }
+    }
+    return true;
 }
 
 } // namespace
@@ -41,7 +161,7 @@ std::shared_ptr<IEffect> Create(const std::string& effectId, const nlohmann::jso
     if (effectId == "SuitMult") {
         int amount = params.value("amount", 0);
         std::string suitStr = params.value("suit", "Spades");
-        return std::make_shared<SuitMultEffect>(amount, parseSuit(suitStr), suitStr);
+        return std::make_shared<SuitMultEffect>(amount, parseSuit(suitStr));
     }
 
     if (effectId == "AbstractJoker") {
@@ -58,4 +178,23 @@ std::shared_ptr<IEffect> Create(const std::string& effectId, const nlohmann::jso
     return nullptr;
 }
 
+std::shared_ptr<const JokerProgram> Compile(const nlohmann::json& params, std::string& error) {
+    if (!params.is_object() || !params.contains("trigger") || !params.contains("do")) {
+        error = "expression requires \"trigger\" and \"do\"";
+        return nullptr;
+    }
+
+    // 谓词在前、动作在后，解释器遇到首个不满足的谓词即可提前结束。
+    auto program = std::make_shared<JokerProgram>();
+    if (!compileTriggers(params["trigger"], *program, error)) return nullptr;
+    if (params.contains("when") && !compileWhen(params["when"], *program, error)) return nullptr;
+    if (!compileDo(params["do"], *program, error)) return nullptr;
+    return program;
+}
+
+std::shared_ptr<IEffect> CreateScripted(std::shared_ptr<const JokerProgram> program) {
+    if (!program) return nullptr;
+    return std::make_shared<ScriptedEffect>(std::move(program));
+}
+
 } // namespace JokerEffectFactory
@@ -5,6 +5,7 @@
 #include <nlohmann/json.hpp>
 
 #include "../Effects/IEffect.hpp"
+#include "../Effects/JokerProgram.hpp"
 
 namespace JokerEffectFactory {
 
@@ -20,4 +21,30 @@ namespace JokerEffectFactory {
  */
 std::shared_ptr<IEffect> Create(const std::string& effectId, const nlohmann::json& params);
 
+/**
+ * 将表达式参数编译为字节码。
+ *
+ * 参数格式：
+ *   "trigger": 阶段名或阶段名数组（Individual/HeldInHand/Global/OnDiscard）
+ *   "when":    可选谓词，支持 suit、rank（点数或点数数组）、
+ *              scoring_at_least、scoring_at_most
+ *   "do":      动作，支持 chips、mult、xmult、dollars，
+ *              "per_joker": true 时加法动作按 Joker 数量放大
+ *
+ * 加载配置时调用一次，结果在同类 Joker 之间共享。
+ *
+ * @param params 效果参数
+ * @param error 失败时写入原因
+ * @return 已编译程序；参数非法返回 nullptr
+ */
+std::shared_ptr<const JokerProgram> Compile(const nlohmann::json& params, std::string& error);
+
+/**
+ * 基于已编译程序创建效果对象。
+ *
+ * @param program 已编译程序
+ * @return 效果对象
+ */
+std::shared_ptr<IEffect> CreateScripted(std::shared_ptr<const JokerProgram> program);
+
 }
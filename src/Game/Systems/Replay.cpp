@@ -0,0 +1,151 @@
+#include "Replay.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+constexpr std::uint8_t MAGIC[4] = {'B', 'R', 'P', 'L'};
+
+bool readIndex(std::span<const std::uint8_t> bytes, std::size_t& pos, int& out) {
+    std::uint64_t value = 0;
+    // 下标只可能是很小的非负数，过大视为损坏。
+    if (!ReplayFormat::ReadVarint(bytes, pos, value) || value > 0xFFFF) return false;
+    out = static_cast<int>(value);
+    return true;
+}
+
+} // namespace
+
+void ReplayFormat::AppendVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+bool ReplayFormat::ReadVarint(std::span<const std::uint8_t> bytes, std::size_t& pos, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= bytes.size()) return false;
+        const std::uint8_t byte = bytes[pos++];
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+void ReplayFormat::AppendHeader(std::vector<std::uint8_t>& out, std::uint64_t seed) {
+    out.insert(out.end(), std::begin(MAGIC), std::end(MAGIC));
+    AppendVarint(out, VERSION);
+    AppendVarint(out, seed);
+}
+
+void ReplayFormat::AppendAction(std::vector<std::uint8_t>& out, const ReplayAction& action) {
+    out.push_back(static_cast<std::uint8_t>(action.op));
+    switch (action.op) {
+        case ReplayOp::Select:
+            AppendVarint(out, action.mask);
+            break;
+        case ReplayOp::Buy:
+            AppendVarint(out, static_cast<std::uint64_t>(action.shopIndex));
+            break;
+        case ReplayOp::Replace:
+            AppendVarint(out, static_cast<std::uint64_t>(action.shopIndex));
+            AppendVarint(out, static_cast<std::uint64_t>(action.jokerIndex));
+            break;
+        case ReplayOp::Play:
+        case ReplayOp::Discard:
+        case ReplayOp::Reroll:
+        case ReplayOp::NextRound:
+            break;
+    }
+}
+
+bool ReplayFormat::Decode(std::span<const std::uint8_t> bytes, Replay& replay, std::string& error) {
+    replay = Replay{};
+    if (bytes.size() < std::size(MAGIC) || !std::equal(std::begin(MAGIC), std::end(MAGIC), bytes.begin())) {
+        error = "not a replay file";
+        return false;
+    }
+
+    std::size_t pos = std::size(MAGIC);
+    std::uint64_t version = 0;
+    if (!ReadVarint(bytes, pos, version) || version != VERSION) {
+        error = "unsupported replay version";
+        return false;
+    }
+    if (!ReadVarint(bytes, pos, replay.seed)) {
+        error = "truncated header";
+        return false;
+    }
+
+    while (pos < bytes.size()) {
+        const std::size_t actionStart = pos;
+        ReplayAction action;
+        action.op = static_cast<ReplayOp>(bytes[pos++]);
+        bool ok = true;
+        switch (action.op) {
+            case ReplayOp::Select: {
+                std::uint64_t mask = 0;
+                ok = ReadVarint(bytes, pos, mask) && mask <= 0xFFFF;
+                action.mask = static_cast<std::uint16_t>(mask);
+                break;
+            }
+            case ReplayOp::Buy:
+                ok = readIndex(bytes, pos, action.shopIndex);
+                break;
+            case ReplayOp::Replace:
+                ok = readIndex(bytes, pos, action.shopIndex) && readIndex(bytes, pos, action.jokerIndex);
+                break;
+            case ReplayOp::Play:
+            case ReplayOp::Discard:
+            case ReplayOp::Reroll:
+            case ReplayOp::NextRound:
+                break;
+            default:
+                ok = false;
+                break;
+        }
+        if (!ok) {
+            error = "corrupt action at byte " + std::to_string(actionStart);
+            return false;
+        }
+        replay.actions.push_back(action);
+    }
+    return true;
+}
+
+bool ReplayFormat::Load(const std::string& path, Replay& replay, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        error = "failed to open " + path;
+        return false;
+    }
+    const std::vector<std::uint8_t> bytes(
+        (std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>()
+    );
+    return Decode(bytes, replay, error);
+}
+
+bool ReplayRecorder::open(const std::string& path, std::uint64_t seed) {
+    m_out.close();
+    m_out.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_out.is_open()) return false;
+
+    m_buffer.clear();
+    ReplayFormat::AppendHeader(m_buffer, seed);
+    m_out.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    m_out.flush();
+    return true;
+}
+
+void ReplayRecorder::record(const ReplayAction& action) {
+    if (!m_out.is_open()) return;
+    m_buffer.clear();
+    ReplayFormat::AppendAction(m_buffer, action);
+    m_out.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    m_out.flush();
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * 回放操作码。
+ *
+ * 数值即文件中的编码，只能追加不能重排。
+ */
+enum class ReplayOp : std::uint8_t {
+    Select = 0,   // 手牌选中状态变为 mask
+    Play = 1,     // 打出当前选中牌
+    Discard = 2,  // 弃掉当前选中牌
+    Buy = 3,      // 空槽购买 shopIndex 商品
+    Replace = 4,  // 以 shopIndex 商品替换 jokerIndex 槽位
+    Reroll = 5,
+    NextRound = 6
+};
+
+/**
+ * 单条玩家操作。
+ */
+struct ReplayAction {
+    ReplayOp op = ReplayOp::NextRound;
+    std::uint16_t mask = 0;  // 第 i 位表示手牌第 i 张，仅 Select 使用
+    int shopIndex = -1;
+    int jokerIndex = -1;
+};
+
+/**
+ * 一局录像：种子加操作序列即可完整复现。
+ */
+struct Replay {
+    std::uint64_t seed = 0;
+    std::vector<ReplayAction> actions;
+};
+
+/**
+ * 回放二进制格式。
+ *
+ * 布局为 "BRPL" 魔数、版本号、种子，之后逐条写入“操作码 + 操作数”，
+ * 整数一律使用 LEB128 变长编码，一整局通常只有几百字节。
+ */
+namespace ReplayFormat {
+
+inline constexpr std::uint64_t VERSION = 1;
+
+/**
+ * 追加无符号变长整数。
+ *
+ * @param out 输出缓冲
+ * @param value 数值
+ */
+void AppendVarint(std::vector<std::uint8_t>& out, std::uint64_t value);
+
+/**
+ * 读取无符号变长整数。
+ *
+ * @param bytes 输入
+ * @param pos 读取位置，成功时前移
+ * @param value 输出数值
+ * @return 是否读取成功
+ */
+bool ReadVarint(std::span<const std::uint8_t> bytes, std::size_t& pos, std::uint64_t& value);
+
+/**
+ * 追加文件头。
+ *
+ * @param out 输出缓冲
+ * @param seed 随机种子
+ */
+void AppendHeader(std::vector<std::uint8_t>& out, std::uint64_t seed);
+
+/**
+ * 追加一条操作。
+ *
+ * @param out 输出缓冲
+ * @param action 操作
+ */
+void AppendAction(std::vector<std::uint8_t>& out, const ReplayAction& action);
+
+/**
+ * 解码整份录像。
+ *
+ * @param bytes 文件内容
+ * @param replay 输出录像
+ * @param error 失败原因
+ * @return 是否解码成功
+ */
+bool Decode(std::span<const std::uint8_t> bytes, Replay& replay, std::string& error);
+
+/**
+ * 从文件加载录像。
+ *
+ * @param path 文件路径
+ * @param replay 输出录像
+ * @param error 失败原因
+ * @return 是否加载成功
+ */
+bool Load(const std::string& path, Replay& replay, std::string& error);
+
+} // namespace ReplayFormat
+
+/**
+ * 录像写入器。
+ *
+ * 每条操作编码后立即写盘，程序异常退出时也能保留崩溃前的全部操作。
+ */
+class ReplayRecorder {
+public:
+    /**
+     * 打开录像文件并写入文件头。
+     *
+     * @param path 文件路径
+     * @param seed 随机种子
+     * @return 是否打开成功
+     */
+    bool open(const std::string& path, std::uint64_t seed);
+
+    /**
+     * 记录一条操作；未打开时忽略。
+     *
+     * @param action 操作
+     */
+    void record(const ReplayAction& action);
+
+    bool isOpen() const { return m_out.is_open(); }
+
+private:
+    std::ofstream m_out;
+    std::vector<std::uint8_t> m_buffer;
+};
@@ -0,0 +1,39 @@
+#include "ScoreTrace.hpp"
+
+namespace {
+
+const char* phaseLabel(TracePhase phase) {
+    switch (phase) {
+        case TracePhase::Base:       return "Base";
+        case TracePhase::Individual: return "Joker";
+        case TracePhase::HeldInHand: return "Held";
+        case TracePhase::Global:     return "Global";
+        case TracePhase::OnDiscard:  return "Discard";
+    }
+    return "";
+}
+
+std::string sourceName(std::int16_t slot, std::span<const std::string> jokerNames) {
+    if (slot >= 0 && slot < static_cast<int>(jokerNames.size())) {
+        return jokerNames[static_cast<std::size_t>(slot)];
+    }
+    return "Joker #" + std::to_string(slot);
+}
+
+} // namespace
+
+std::string ScoreTrace::Format(const ScoreTraceEvent& event, std::span<const std::string> jokerNames) {
+    if (event.op == TraceOp::BaseChips) return "Base: " + std::to_string(event.delta) + " Chips";
+    if (event.op == TraceOp::BaseMult) return "Base: " + std::to_string(event.delta) + " Mult";
+    if (event.op == TraceOp::CardChips) return "Card: +" + std::to_string(event.delta) + " Chips";
+
+    std::string text = std::string(phaseLabel(event.phase)) + " (" + sourceName(event.source_slot, jokerNames) + "): ";
+    switch (event.op) {
+        case TraceOp::AddChips:   return text + "+" + std::to_string(event.delta) + " Chips";
+        case TraceOp::AddMult:    return text + "+" + std::to_string(event.delta) + " Mult";
+        case TraceOp::XMult:      return text + "X" + std::to_string(event.factor);
+        case TraceOp::AddDollars: return text + "+$" + std::to_string(event.delta);
+        default: break;
+    }
+    return text;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+/**
+ * 追踪事件所属的结算阶段。
+ */
+enum class TracePhase : std::uint8_t {
+    Base,
+    Individual,
+    HeldInHand,
+    Global,
+    OnDiscard
+};
+
+/**
+ * 追踪事件的数值操作。
+ */
+enum class TraceOp : std::uint8_t {
+    BaseChips,
+    BaseMult,
+    CardChips,
+    AddChips,
+    AddMult,
+    XMult,
+    AddDollars
+};
+
+/**
+ * 单条结算追踪事件。
+ *
+ * 仅记录定长数值，文本在需要展示时再由 ScoreTrace::Format 生成。
+ */
+struct ScoreTraceEvent {
+    std::int16_t source_slot = -1;  // 触发来源在 Joker 区的槽位，-1 表示基础值
+    TracePhase phase = TracePhase::Base;
+    TraceOp op = TraceOp::BaseChips;
+    int delta = 0;                  // 筹码/倍率/金钱的增量或基础值
+    float factor = 1.0f;            // 仅 XMult 使用
+};
+
+/**
+ * 调用方提供存储的结算追踪缓冲。
+ *
+ * 计分接口默认不追踪；只有传入该缓冲时才写入事件，
+ * 无界面运行与模拟因此不承担任何日志开销。
+ * 写满后新事件被丢弃并计数，记录过程不会分配内存。
+ */
+class ScoreTrace {
+public:
+    /**
+     * 绑定外部存储。
+     *
+     * @param storage 事件存储
+     */
+    explicit ScoreTrace(std::span<ScoreTraceEvent> storage) : m_storage(storage) {}
+
+    /**
+     * 追加一条事件。
+     *
+     * @param event 事件
+     */
+    void record(const ScoreTraceEvent& event) {
+        if (m_count < m_storage.size()) {
+            m_storage[m_count++] = event;
+        } else {
+            ++m_dropped;
+        }
+    }
+
+    /**
+     * 清空已记录事件，存储可复用。
+     */
+    void clear() {
+        m_count = 0;
+        m_dropped = 0;
+    }
+
+    /**
+     * 获取已记录事件。
+     *
+     * @return 事件列表
+     */
+    std::span<const ScoreTraceEvent> events() const { return m_storage.first(m_count); }
+
+    /**
+     * 获取因容量不足被丢弃的事件数。
+     *
+     * @return 丢弃数量
+     */
+    std::size_t dropped() const { return m_dropped; }
+
+    /**
+     * 将事件格式化为调试文本。
+     *
+     * 槽位按结算时的编队解析名称，编队变化后名称可能对不上，
+     * 因此应在同一次结算后尽快格式化。
+     *
+     * @param event 事件
+     * @param jokerNames 结算时编队中各槽位的名称，可为空
+     * @return 文本描述
+     */
+    static std::string Format(const ScoreTraceEvent& event, std::span<const std::string> jokerNames = {});
+
+private:
+    std::span<ScoreTraceEvent> m_storage;
+    std::size_t m_count = 0;
+    std::size_t m_dropped = 0;
+};
@@ -1,66 +1,98 @@
 #include "ScoringManager.hpp"
 
+#include <cassert>
+
 #include "../Effects/IEffect.hpp"
-#include "CardSnapshotUtils.hpp"
+
+namespace {
+
+/**
+ * 求值单个效果绑定。
+ *
+ * 内置效果直接分支求值；自定义效果才经过 IEffect 虚调用。
+ *
+ * @param binding 效果绑定
+ * @param ctx 触发上下文
+ * @param out 触发时写入的结果
+ * @return 是否触发
+ */
+inline bool evaluateBinding(const EffectBinding& binding, const EffectContext& ctx, EffectResult& out) {
+    if (binding.builtin) return EvaluateBuiltin(binding.spec, ctx, out);
+    assert(binding.source && "custom IEffect requires a source card");
+    auto res = binding.effect->Calculate(*binding.source, ctx);
+    if (!res || !res->triggered) return false;
+    out = *res;
+    return true;
+}
+
+} // namespace
 
 ScoreSummary ScoringManager::CalculateFinalScore(
     int baseChips,
     int baseMult,
-    const std::vector<CardSnapshot>& scoringCards,
-    CardArea* handArea,
-    CardArea* jokerArea
+    std::span<const CardSnapshot> scoringCards,
+    std::span<const CardSnapshot> heldCards,
+    const EffectPipeline* jokers,
+    ScoreTrace* trace
 ) {
     ScoreSummary summary;
     int currentChips = baseChips;
     int currentMult = baseMult;
 
     // 记录基础值，便于调试触发链条时回溯最终来源。
-    summary.trigger_log.push_back("Base: " + std::to_string(currentChips) + " x " + std::to_string(currentMult));
+    if (trace) {
+        trace->record({.phase = TracePhase::Base, .op = TraceOp::BaseChips, .delta = currentChips});
+        trace->record({.phase = TracePhase::Base, .op = TraceOp::BaseMult, .delta = currentMult});
+    }
 
     EffectContext ctx;
     ctx.scoring_snapshots = scoringCards;
-    ctx.hand_area = handArea;
-    ctx.joker_area = jokerArea;
+    ctx.held_snapshots = heldCards;
+    ctx.joker_count = jokers ? jokers->slotCount() : 0;
 
     // 先叠加计分牌基础筹码，再进入效果链，保持与玩法结算顺序一致。
     for (const auto& card : scoringCards) {
         currentChips += card.chips;
+        if (trace) trace->record({.phase = TracePhase::Base, .op = TraceOp::CardChips, .delta = card.chips});
     }
 
     // 第一阶段：逐张计分牌触发 Individual 效果。
-    if (jokerArea) {
+    if (jokers) {
         ctx.trigger = TriggerType::Individual;
+        const auto effects = jokers->forTrigger(ctx.trigger);
         for (const auto& playingCard : scoringCards) {
+            if (effects.empty()) break;
             ctx.other_card_snapshot = playingCard;
             ctx.has_other_card_snapshot = true;
-            for (auto& joker : jokerArea->getCards()) {
-                processEffect(joker, ctx, currentChips, currentMult, summary, "Joker");
+            for (const auto& binding : effects) {
+                processEffect(binding, ctx, currentChips, currentMult, trace, TracePhase::Individual);
             }
         }
     }
 
     // 第二阶段：对“未出牌手持牌”触发 HeldInHand 效果。
-    if (handArea && jokerArea) {
+    if (jokers) {
         ctx.trigger = TriggerType::HeldInHand;
-        auto heldCards = CardSnapshotUtils::BuildHeldInHand(*handArea);
+        const auto effects = jokers->forTrigger(ctx.trigger);
         for (const auto& heldCard : heldCards) {
+            if (effects.empty()) break;
             ctx.other_card_snapshot = heldCard;
             ctx.has_other_card_snapshot = true;
-            for (auto& joker : jokerArea->getCards()) {
-                processEffect(joker, ctx, currentChips, currentMult, summary, "Held");
+            for (const auto& binding : effects) {
+                processEffect(binding, ctx, currentChips, currentMult, trace, TracePhase::HeldInHand);
             }
         }
     }
 
     // 第三阶段：执行全局效果，作为本次结算的最终修正层。
-    if (jokerArea) {
+    if (jokers) {
         ctx.trigger = TriggerType::Global;
         ctx.has_other_card_snapshot = false;
         ctx.current_chips = currentChips;
         ctx.current_mult = currentMult;
 
-        for (auto& joker : jokerArea->getCards()) {
-            processEffect(joker, ctx, currentChips, currentMult, summary, "Global");
+        for (const auto& binding : jokers->forTrigger(ctx.trigger)) {
+            processEffect(binding, ctx, currentChips, currentMult, trace, TracePhase::Global);
         }
     }
 
@@ -71,38 +103,64 @@ ScoreSummary ScoringManager::CalculateFinalScore(
 }
 
 ScoreSummary ScoringManager::CalculateDiscardEffect(
-    const std::vector<CardSnapshot>& discardedCards,
-    CardArea* jokerArea
+    std::span<const CardSnapshot> discardedCards,
+    const EffectPipeline* jokers,
+    ScoreTrace* trace
 ) {
     ScoreSummary summary;
     EffectContext ctx;
-    ctx.joker_area = jokerArea;
+    ctx.joker_count = jokers ? jokers->slotCount() : 0;
     ctx.scoring_snapshots = discardedCards;
 
-    if (!jokerArea) return summary;
+    if (!jokers) return summary;
 
     // 弃牌链路独立于出牌链路，避免两类触发条件互相污染。
     ctx.trigger = TriggerType::OnDiscard;
+    const auto effects = jokers->forTrigger(ctx.trigger);
+    if (effects.empty()) return summary;
+
     for (const auto& card : discardedCards) {
         ctx.other_card_snapshot = card;
         ctx.has_other_card_snapshot = true;
 
-        for (auto& joker : jokerArea->getCards()) {
-            auto effect = joker->getEffect();
-            if (!effect) continue;
-
-            auto res = effect->Calculate(*joker, ctx);
-            if (!res || !res->triggered) continue;
-
-            if (res->dollars_add > 0) {
-                summary.dollars += res->dollars_add;
-                summary.trigger_log.push_back(
-                    "Discard (" + joker->getAbilityName() + "): +$" + std::to_string(res->dollars_add)
-                );
+        for (const auto& binding : effects) {
+            EffectResult res;
+            if (!evaluateBinding(binding, ctx, res)) continue;
+
+            if (res.dollars_add > 0) {
+                summary.dollars += res.dollars_add;
+                if (trace) {
+                    trace->record({
+                        .source_slot = binding.slot,
+                        .phase = TracePhase::OnDiscard,
+                        .op = TraceOp::AddDollars,
+                        .delta = res.dollars_add,
+                    });
+                }
             }
 
-            if (res->chips_add > 0) summary.final_chips += res->chips_add;
-            if (res->mult_add > 0) summary.final_mult += res->mult_add;
+            if (res.chips_add > 0) {
+                summary.final_chips += res.chips_add;
+                if (trace) {
+                    trace->record({
+                        .source_slot = binding.slot,
+                        .phase = TracePhase::OnDiscard,
+                        .op = TraceOp::AddChips,
+                        .delta = res.chips_add,
+                    });
+                }
+            }
+            if (res.mult_add > 0) {
+                summary.final_mult += res.mult_add;
+                if (trace) {
+                    trace->record({
+                        .source_slot = binding.slot,
+                        .phase = TracePhase::OnDiscard,
+                        .op = TraceOp::AddMult,
+                        .delta = res.mult_add,
+                    });
+                }
+            }
         }
     }
 
@@ -110,31 +168,42 @@ ScoreSummary ScoringManager::CalculateDiscardEffect(
 }
 
 void ScoringManager::processEffect(
-    const std::shared_ptr<Card>& sourceCard,
+    const EffectBinding& binding,
     const EffectContext& ctx,
     int& chips,
     int& mult,
-    ScoreSummary& summary,
-    const std::string& prefix
+    ScoreTrace* trace,
+    TracePhase phase
 ) {
-    auto effect = sourceCard->getEffect();
-    if (!effect) return;
+    EffectResult res;
+    if (!evaluateBinding(binding, ctx, res)) return;
 
-    auto res = effect->Calculate(*sourceCard, ctx);
-    if (!res || !res->triggered) return;
-
-    if (res->chips_add > 0) chips += res->chips_add;
-    if (res->mult_add > 0) mult += res->mult_add;
+    if (res.chips_add > 0) chips += res.chips_add;
+    if (res.mult_add > 0) mult += res.mult_add;
 
     // x_mult 属于“后乘”修正，必须在加法修正后应用以符合设计语义。
-    if (res->x_mult > 1.0f) {
-        mult = static_cast<int>(mult * res->x_mult);
-        summary.trigger_log.push_back(
-            prefix + " (" + sourceCard->getAbilityName() + "): X" + std::to_string(res->x_mult)
-        );
-    } else {
-        summary.trigger_log.push_back(
-            prefix + " (" + sourceCard->getAbilityName() + "): " + res->message
-        );
+    if (res.x_mult > 1.0f) {
+        mult = static_cast<int>(mult * res.x_mult);
+    }
+
+    if (!trace) return;
+    const ScoreTraceEvent event{.source_slot = binding.slot, .phase = phase};
+    if (res.chips_add > 0) {
+        ScoreTraceEvent e = event;
+        e.op = TraceOp::AddChips;
+        e.delta = res.chips_add;
+        trace->record(e);
+    }
+    if (res.mult_add > 0) {
+        ScoreTraceEvent e = event;
+        e.op = TraceOp::AddMult;
+        e.delta = res.mult_add;
+        trace->record(e);
+    }
+    if (res.x_mult > 1.0f) {
+        ScoreTraceEvent e = event;
+        e.op = TraceOp::XMult;
+        e.factor = res.x_mult;
+        trace->record(e);
     }
 }
@@ -1,17 +1,17 @@
 #pragma once
+#include <span>
 #include <vector>
-#include <string>
 #include <memory>
 #include "CardSnapshot.hpp"
+#include "ScoreTrace.hpp"
 #include "../Effects/EffectContext.hpp"
-#include "../Objects/CardArea.hpp"
+#include "../Effects/EffectPipeline.hpp"
 
 struct ScoreSummary {
     long long final_score = 0;
     int final_chips = 0;
     int final_mult = 0;
     int dollars = 0;
-    std::vector<std::string> trigger_log;
 };
 
 class ScoringManager {
@@ -19,40 +19,47 @@ public:
     /**
      * 计算出牌最终得分。
      *
+     * 手持牌由调用方给出，既用于实际出牌，也用于评估假设性出牌；
+     * 整个结算只读取快照与效果流水线，不产生堆分配。
+     *
      * @param baseChips 基础筹码
      * @param baseMult 基础倍率
      * @param scoringCards 计分牌快照
-     * @param handArea 手牌区
-     * @param jokerArea Joker 区
+     * @param heldCards 未出的手持牌快照
+     * @param jokers Joker 效果流水线，可为空
+     * @param trace 可选追踪缓冲，为空时不记录
      * @return 结算结果
      */
     static ScoreSummary CalculateFinalScore(
         int baseChips,
         int baseMult,
-        const std::vector<CardSnapshot>& scoringCards,
-        CardArea* handArea,
-        CardArea* jokerArea
+        std::span<const CardSnapshot> scoringCards,
+        std::span<const CardSnapshot> heldCards,
+        const EffectPipeline* jokers,
+        ScoreTrace* trace = nullptr
     );
 
     /**
      * 计算弃牌阶段效果。
      *
      * @param discardedCards 弃牌快照
-     * @param jokerArea Joker 区
+     * @param jokers Joker 效果流水线，可为空
+     * @param trace 可选追踪缓冲，为空时不记录
      * @return 结算结果
      */
     static ScoreSummary CalculateDiscardEffect(
-        const std::vector<CardSnapshot>& discardedCards,
-        CardArea* jokerArea
+        std::span<const CardSnapshot> discardedCards,
+        const EffectPipeline* jokers,
+        ScoreTrace* trace = nullptr
     );
 
 private:
     static void processEffect(
-        const std::shared_ptr<Card>& sourceCard, 
+        const EffectBinding& binding,
         const EffectContext& ctx, 
         int& chips, 
         int& mult, 
-        ScoreSummary& summary,
-        const std::string& prefix
+        ScoreTrace* trace,
+        TracePhase phase
     );
 };
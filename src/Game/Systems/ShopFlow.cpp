@@ -1,7 +1,5 @@
 #include "ShopFlow.hpp"
 
-#include "../Objects/CardArea.hpp"
-
 bool ShopFlow::TrySpend(GameContext& ctx, int amount) {
     // 拒绝负数金额，避免调用方错误造成“反向加钱”漏洞。
     if (amount < 0) return false;
@@ -18,11 +16,12 @@ bool ShopFlow::TryReroll(GameContext& ctx, int rerollCost) {
 ShopPurchaseDecision ShopFlow::EvaluatePurchase(
     const GameContext& ctx,
     int cost,
+    int ownedJokers,
     int jokerLimit
 ) {
     ShopPurchaseDecision decision;
     // 先做输入合法性防御，避免 UI 异常输入污染购买状态。
-    if (cost < 0 || jokerLimit <= 0 || !ctx.hasJokerArea()) {
+    if (cost < 0 || ownedJokers < 0 || jokerLimit <= 0) {
         return decision;
     }
 
@@ -32,6 +31,6 @@ ShopPurchaseDecision ShopFlow::EvaluatePurchase(
 
     // 预算通过后再判断是否需要替换，减少 UI 层条件重复。
     decision.affordable = true;
-    decision.requiresReplace = static_cast<int>(ctx.jokerArea().getCards().size()) >= jokerLimit;
+    decision.requiresReplace = ownedJokers >= jokerLimit;
     return decision;
 }
@@ -33,14 +33,18 @@ bool TryReroll(GameContext& ctx, int rerollCost = DEFAULT_REROLL_COST);
 /**
  * 评估购买可行性。
  *
+ * 已持有数量由调用方给出，规则判定不依赖卡牌区域对象。
+ *
  * @param ctx 上下文
  * @param cost 商品价格
+ * @param ownedJokers 已持有 Joker 数量
  * @param jokerLimit Joker 槽位上限
  * @return 购买判定结果
  */
 ShopPurchaseDecision EvaluatePurchase(
     const GameContext& ctx,
     int cost,
+    int ownedJokers,
     int jokerLimit = DEFAULT_JOKER_LIMIT
 );
 
@@ -1,7 +1,5 @@
 #include "ShopRestock.hpp"
 
-#include <cstdlib>
-
 std::vector<std::string> ShopRestock::PickIds(
     const std::vector<std::string>& pool,
     int count,
@@ -22,13 +20,10 @@ std::vector<std::string> ShopRestock::PickIds(
     return selected;
 }
 
-std::vector<std::string> ShopRestock::PickIdsWithStdRand(
+std::vector<std::string> ShopRestock::PickIds(
     const std::vector<std::string>& pool,
-    int count
+    int count,
+    RngStream& rng
 ) {
-    // 当前采用标准随机即可满足商店波动需求。
-    // TODO: 若后续需要回放，可在此替换为可注入随机源实现。
-    return PickIds(pool, count, [](std::size_t bound) {
-        return static_cast<std::size_t>(std::rand() % static_cast<int>(bound));
-    });
+    return PickIds(pool, count, [&rng](std::size_t bound) { return rng.uniform(bound); });
 }
@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 
+#include "../Core/Rng.hpp"
+
 namespace ShopRestock {
 
 using PickIndexFn = std::function<std::size_t(std::size_t bound)>;
@@ -24,15 +26,17 @@ std::vector<std::string> PickIds(
 );
 
 /**
- * 使用标准随机数生成补货 ID。
+ * 使用随机流生成补货 ID。
  *
  * @param pool 商品池
  * @param count 选择数量
+ * @param rng 随机流
  * @return 选中的 ID 列表
  */
-std::vector<std::string> PickIdsWithStdRand(
+std::vector<std::string> PickIds(
     const std::vector<std::string>& pool,
-    int count
+    int count,
+    RngStream& rng
 );
 
 } // namespace ShopRestock
@@ -42,14 +42,23 @@ void UIManager::update(const GameContext& ctx) {
     m_textDeckCount.setString("Deck: " + std::to_string(ctx.deck.getRemainingCount()));
 }
 
-void UIManager::updateHandInfo(const std::string& handName, int level, int chips, int mult) {
+void UIManager::updateHandInfo(std::string_view handName, int level, int chips, int mult) {
+    if (handName == m_shownHandName && level == m_shownHandLevel &&
+        chips == m_shownChips && mult == m_shownMult) {
+        return;
+    }
+    m_shownHandName.assign(handName);
+    m_shownHandLevel = level;
+    m_shownChips = chips;
+    m_shownMult = mult;
+
     if (handName.empty()) {
         m_textHandType.setString("Select Hand");
         m_textHandLevel.setString("");
         m_textBaseChips.setString("-");
         m_textBaseMult.setString("-");
     } else {
-        m_textHandType.setString(handName);
+        m_textHandType.setString(m_shownHandName);
         m_textHandLevel.setString("Lvl." + std::to_string(level));
         m_textBaseChips.setString(std::to_string(chips));
         m_textBaseMult.setString(std::to_string(mult));
@@ -1,6 +1,7 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <string>
+#include <string_view>
 #include "../Core/GameContext.hpp"
 
 class UIManager {
@@ -27,12 +28,14 @@ public:
     /**
      * 更新牌型面板信息。
      *
+     * 内容与上次相同时直接返回，避免每帧重建文本布局。
+     *
      * @param handName 牌型名称
      * @param level 牌型等级
      * @param chips 基础筹码
      * @param mult 基础倍率
      */
-    void updateHandInfo(const std::string& handName, int level, int chips, int mult);
+    void updateHandInfo(std::string_view handName, int level, int chips, int mult);
 
     /**
      * 设置商店提示文本。
@@ -67,4 +70,10 @@ private:
     sf::Text m_textBaseChips;
     sf::Text m_textBaseMult;
     sf::Text m_textMultSymbol;
+
+    // 牌型面板上次显示的内容，用于跳过重复刷新。
+    std::string m_shownHandName;
+    int m_shownHandLevel = -1;
+    int m_shownChips = -1;
+    int m_shownMult = -1;
 };
@@ -1,7 +1,73 @@
 #include "Game/Core/Game.hpp"
+#include "Game/Sim/ReplayRunner.hpp"
 
-int main() {
-    Game game;
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+/**
+ * 无界面全速回放录像并输出终局状态。
+ *
+ * @param path 录像路径
+ * @return 进程退出码
+ */
+int runHeadlessReplay(const std::string& path) {
+    Replay replay;
+    std::string error;
+    if (!ReplayFormat::Load(path, replay, error)) {
+        std::cerr << "[Fatal] " << error << std::endl;
+        return 1;
+    }
+
+    GameDatabase db;
+    if (!db.loadRanks("assets/data/ranks.json") || !db.loadJokers("assets/data/jokers.json")) {
+        std::cerr << "[Fatal] Failed to load game data." << std::endl;
+        return 1;
+    }
+
+    RunSimulator sim(db, ReplayRunner::ConfigFor(replay));
+    const std::size_t applied = ReplayRunner::Run(sim, replay);
+    std::cout << "seed=" << replay.seed
+              << " actions=" << applied << "/" << replay.actions.size()
+              << " rounds=" << sim.roundsCleared()
+              << " score=" << sim.context().currentScore
+              << " money=" << sim.context().money << std::endl;
+    return applied == replay.actions.size() ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    GameOptions options;
+    bool headless = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--replay" && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (arg == "--speed" && hasValue) {
+            options.replaySpeed = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--record" && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (arg == "--headless") {
+            headless = true;
+        } else {
+            std::cout << "Usage: Balatro-Cpp [--record FILE] [--replay FILE [--speed X] [--headless]]\n";
+            return 2;
+        }
+    }
+
+    if (headless) {
+        if (options.replayPath.empty()) {
+            std::cerr << "[Fatal] --headless requires --replay FILE" << std::endl;
+            return 2;
+        }
+        return runHeadlessReplay(options.replayPath);
+    }
+
+    Game game(options);
     game.run();
 
     return 0;
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Game/Sim/RunSimulator.hpp"
+#include "Game/Sim/SimPolicy.hpp"
+#include "Game/Sim/WorkStealing.hpp"
+#include "Game/Systems/GameDatabase.hpp"
+
+namespace {
+
+constexpr std::size_t HAND_TYPE_COUNT = 13;
+
+struct CliOptions {
+    std::size_t runs = 10000;
+    std::uint64_t seed = 1;
+    unsigned threads = 0;
+    int maxRounds = 24;
+    std::string dataDir = "assets/data";
+    std::string csvPath;
+};
+
+/**
+ * 单局结果。
+ */
+struct RunRecord {
+    std::uint64_t seed = 0;
+    int ante = 0;
+    int roundsCleared = 0;
+    int money = 0;
+    bool victory = false;
+    bool failed = false;  // 策略给出非法操作
+    std::array<int, HAND_TYPE_COUNT> handTypes{};
+};
+
+/**
+ * 线程私有结果缓冲。
+ *
+ * 每个工作线程只写自己的缓冲，按缓存行对齐避免伪共享，结束后统一合并。
+ */
+struct alignas(64) WorkerBuffer {
+    std::vector<RunRecord> records;
+};
+
+void printUsage() {
+    std::cout << "Usage: balatro-farm [--runs N] [--seed S] [--threads T] [--rounds R] [--data DIR] [--csv FILE]\n"
+              << "  Plays N seeded headless runs across T threads (default: all cores).\n";
+}
+
+bool parseArgs(int argc, char** argv, CliOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--runs" && hasValue) {
+            options.runs = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--rounds" && hasValue) {
+            options.maxRounds = std::atoi(argv[++i]);
+        } else if (arg == "--data" && hasValue) {
+            options.dataDir = argv[++i];
+        } else if (arg == "--csv" && hasValue) {
+            options.csvPath = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return options.runs > 0 && options.maxRounds > 0;
+}
+
+RunRecord simulateRun(const GameDatabase& db, std::uint64_t seed, int maxRounds) {
+    SimConfig config;
+    config.seed = seed;
+    config.maxRounds = maxRounds;
+
+    RunSimulator sim(db, config);
+    RunRecord record;
+    record.seed = seed;
+    record.failed = SimPolicy::PlayOutGreedy(sim) < 0;
+    record.ante = sim.ante();
+    record.roundsCleared = sim.roundsCleared();
+    record.money = sim.context().money;
+    record.victory = sim.context().state == GameState::Victory;
+    record.handTypes = sim.handTypeCounts();
+    return record;
+}
+
+void writeCsv(const std::string& path, const std::vector<RunRecord>& records) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "[Error] Failed to open " << path << std::endl;
+        return;
+    }
+    out << "seed,ante,rounds,money,victory";
+    for (std::size_t t = 0; t < HAND_TYPE_COUNT; ++t) {
+        out << ',' << HandEvaluator::GetHandName(static_cast<PokerHandType>(t));
+    }
+    out << '\n';
+    for (const auto& r : records) {
+        out << r.seed << ',' << r.ante << ',' << r.roundsCleared << ',' << r.money << ',' << r.victory;
+        for (int count : r.handTypes) out << ',' << count;
+        out << '\n';
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CliOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    // 数据库加载后只读，是各线程之间唯一共享的对象。
+    GameDatabase db;
+    if (!db.loadRanks(options.dataDir + "/ranks.json") || !db.loadJokers(options.dataDir + "/jokers.json")) {
+        std::cerr << "[Fatal] Failed to load game data from " << options.dataDir << std::endl;
+        return 1;
+    }
+
+    const unsigned threads = options.threads != 0
+        ? options.threads
+        : std::max(1u, std::thread::hardware_concurrency());
+    auto buffers = std::make_unique<WorkerBuffer[]>(threads);
+    for (unsigned w = 0; w < threads; ++w) {
+        buffers[w].records.reserve(options.runs / threads + 1);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    WorkStealing::ParallelFor(options.runs, threads, [&](std::size_t index, unsigned worker) {
+        buffers[worker].records.push_back(
+            simulateRun(db, options.seed + static_cast<std::uint64_t>(index), options.maxRounds)
+        );
+    });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 合并线程缓冲并按种子排序，输出与线程数和调度顺序无关。
+    std::vector<RunRecord> records;
+    records.reserve(options.runs);
+    for (unsigned w = 0; w < threads; ++w) {
+        records.insert(records.end(), buffers[w].records.begin(), buffers[w].records.end());
+    }
+    std::sort(records.begin(), records.end(), [](const RunRecord& a, const RunRecord& b) {
+        return a.seed < b.seed;
+    });
+
+    long long anteSum = 0;
+    long long moneySum = 0;
+    int victories = 0;
+    int failures = 0;
+    std::array<long long, HAND_TYPE_COUNT> handTypes{};
+    for (const auto& r : records) {
+        anteSum += r.ante;
+        moneySum += r.money;
+        victories += r.victory ? 1 : 0;
+        failures += r.failed ? 1 : 0;
+        for (std::size_t t = 0; t < HAND_TYPE_COUNT; ++t) handTypes[t] += r.handTypes[t];
+    }
+
+    const double runCount = static_cast<double>(records.size());
+    std::cout << "runs=" << records.size()
+              << " threads=" << threads
+              << " victories=" << victories
+              << " avg_ante=" << anteSum / runCount
+              << " avg_money=" << moneySum / runCount
+              << " runs_per_sec=" << (seconds > 0 ? runCount / seconds : 0.0)
+              << '\n';
+    for (std::size_t t = 0; t < HAND_TYPE_COUNT; ++t) {
+        if (handTypes[t] == 0) continue;
+        std::cout << "  " << HandEvaluator::GetHandName(static_cast<PokerHandType>(t)) << ": " << handTypes[t] << '\n';
+    }
+
+    if (!options.csvPath.empty()) writeCsv(options.csvPath, records);
+
+    if (failures > 0) {
+        std::cerr << "[Error] " << failures << " run(s) stopped on an illegal policy action." << std::endl;
+        return 1;
+    }
+    return 0;
+}
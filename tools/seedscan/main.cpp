@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Game/Core/GameContext.hpp"
+#include "Game/Core/PackedDeck.hpp"
+#include "Game/Core/Rng.hpp"
+#include "Game/Sim/BatchShuffle.hpp"
+#include "Game/Sim/RunSimulator.hpp"
+#include "Game/Sim/WorkStealing.hpp"
+#include "Game/Systems/GameDatabase.hpp"
+
+namespace {
+
+constexpr int RANKS_PER_SUIT = 13;
+constexpr std::size_t HAND_SIZE = GameContext::HAND_SIZE_LIMIT;
+
+using Hand = std::array<std::uint8_t, HAND_SIZE>;
+
+// 每个任务扫描的种子数，足够大以摊薄窃取开销，又足够小以保持负载均衡。
+constexpr std::uint64_t CHUNK_SEEDS = 1 << 16;
+// 一次批量洗牌的种子数。
+constexpr std::size_t SHUFFLE_BATCH = 64;
+
+struct CliOptions {
+    std::uint64_t from = 1;
+    std::uint64_t count = 1000000;
+    unsigned threads = 0;
+    std::string dataDir = "assets/data";
+    std::string outPath = "seeds.txt";
+
+    // 谓词：全部满足才算命中，未指定的谓词不参与判断。
+    int minSuited = 0;                 // 开局手牌中同一花色至少几张
+    int minOfAKind = 0;                // 开局手牌中同一点数至少几张
+    std::vector<std::string> shopJokers;  // 每个 Joker 都要在首个商店的前若干次刷新内出现
+    int rerolls = 0;
+    int shopSize = 3;
+};
+
+/**
+ * 编译后的谓词：Joker ID 已换成排序池下标。
+ */
+struct ScanQuery {
+    int minSuited = 0;
+    int minOfAKind = 0;
+    std::vector<std::size_t> shopJokers;
+    std::size_t poolSize = 0;
+    int shopPicks = 0;  // 首个商店 + 刷新共抽取的商品数
+};
+
+/**
+ * 线程私有命中缓冲，按缓存行对齐避免伪共享。
+ */
+struct alignas(64) WorkerBuffer {
+    std::vector<std::uint64_t> seeds;
+};
+
+void printUsage() {
+    std::cout << "Usage: balatro-seedscan [--from S] [--count N] [--threads T] [--data DIR] [--out FILE]\n"
+              << "                        [--flush-draw] [--min-suited K] [--min-of-a-kind K]\n"
+              << "                        [--shop-joker ID]... [--rerolls N] [--shop-size K]\n"
+              << "  Scans seeds S..S+N-1, replaying only the opening shuffle and shop picks,\n"
+              << "  and writes every seed matching all given predicates to FILE.\n";
+}
+
+bool parseArgs(int argc, char** argv, CliOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--from" && hasValue) {
+            options.from = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--count" && hasValue) {
+            options.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--data" && hasValue) {
+            options.dataDir = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            options.outPath = argv[++i];
+        } else if (arg == "--flush-draw") {
+            options.minSuited = std::max(options.minSuited, 4);
+        } else if (arg == "--min-suited" && hasValue) {
+            options.minSuited = std::atoi(argv[++i]);
+        } else if (arg == "--min-of-a-kind" && hasValue) {
+            options.minOfAKind = std::atoi(argv[++i]);
+        } else if (arg == "--shop-joker" && hasValue) {
+            options.shopJokers.push_back(argv[++i]);
+        } else if (arg == "--rerolls" && hasValue) {
+            options.rerolls = std::atoi(argv[++i]);
+        } else if (arg == "--shop-size" && hasValue) {
+            options.shopSize = std::atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.count > 0 && options.rerolls >= 0 && options.shopSize > 0;
+}
+
+/**
+ * 求一批种子的开局手牌（牌编码为花色 * 13 + 点数 - 2）。
+ *
+ * 与 Deck::initStandardDeck + Deck::shuffle + 逐张 draw 等价：洗牌从尾部向前进行，
+ * 前 HAND_SIZE 步之后尾部的 HAND_SIZE 张已经确定，其余交换不影响开局手牌，可以省略。
+ * 同一批种子的洗牌交给 BatchShuffle 成批生成随机数。
+ *
+ * @param firstSeed 首个种子
+ * @param count 种子数，不超过 SHUFFLE_BATCH
+ * @param hands 输出的手牌编码
+ */
+void openingHands(std::uint64_t firstSeed, std::size_t count, std::array<Hand, SHUFFLE_BATCH>& hands) {
+    std::array<RngStream, SHUFFLE_BATCH> streams;
+    std::array<BatchShuffle::Permutation, SHUFFLE_BATCH> orders;
+    for (std::size_t i = 0; i < count; ++i) {
+        streams[i] = RngStream(firstSeed + i, RngService::StreamNumber(RngStreamId::Deck));
+    }
+    BatchShuffle::Shuffle(std::span(streams.data(), count), std::span(orders.data(), count), HAND_SIZE);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t k = 0; k < HAND_SIZE; ++k) hands[i][k] = orders[i][orders[i].size() - 1 - k];
+    }
+}
+
+bool matchesHand(const ScanQuery& query, const Hand& hand) {
+    std::array<int, 4> suits{};
+    std::array<int, RANKS_PER_SUIT> ranks{};
+    for (const std::uint8_t card : hand) {
+        ++suits[card / RANKS_PER_SUIT];
+        ++ranks[card % RANKS_PER_SUIT];
+    }
+    if (query.minSuited > 0 && *std::max_element(suits.begin(), suits.end()) < query.minSuited) return false;
+    if (query.minOfAKind > 0 && *std::max_element(ranks.begin(), ranks.end()) < query.minOfAKind) return false;
+    return true;
+}
+
+bool matchesShop(const ScanQuery& query, std::uint64_t seed) {
+    if (query.shopJokers.empty()) return true;
+    RngService rng(seed);
+    RngStream& stream = rng.stream(RngStreamId::Shop);
+
+    // 与 ShopRestock::PickIds 的取值一致：每个商品消耗一次 uniform(池大小)。
+    std::uint64_t seen = 0;
+    std::uint64_t wanted = 0;
+    for (const std::size_t index : query.shopJokers) wanted |= 1ULL << index;
+    for (int pick = 0; pick < query.shopPicks; ++pick) {
+        const std::size_t index = stream.uniform(query.poolSize);
+        if (index < 64) seen |= 1ULL << index;
+        if ((seen & wanted) == wanted) return true;
+    }
+    return false;
+}
+
+/**
+ * 用真实模拟器核对前若干个种子的开局手牌，防止捷径与 Deck 的实现脱节。
+ */
+bool verifyOpeningHands(const GameDatabase& db, std::uint64_t from, std::size_t samples) {
+    std::array<Hand, SHUFFLE_BATCH> hands;
+    openingHands(from, samples, hands);
+    for (std::size_t s = 0; s < samples; ++s) {
+        SimConfig config;
+        config.seed = from + s;
+        RunSimulator sim(db, config);
+
+        const Hand& hand = hands[s];
+        if (sim.hand().size() != hand.size()) return false;
+        for (std::size_t i = 0; i < hand.size(); ++i) {
+            const CardSnapshot& card = sim.hand()[i];
+            if (PackedDeck::IndexOf(card.suit, card.rank) != hand[i]) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CliOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    GameDatabase db;
+    if (!db.loadRanks(options.dataDir + "/ranks.json") || !db.loadJokers(options.dataDir + "/jokers.json")) {
+        std::cerr << "[Fatal] Failed to load game data from " << options.dataDir << std::endl;
+        return 1;
+    }
+    if (!verifyOpeningHands(db, options.from, 16)) {
+        std::cerr << "[Fatal] Opening-hand shortcut disagrees with RunSimulator" << std::endl;
+        return 1;
+    }
+
+    // 商品池与 RunSimulator 相同：排序后的全部 Joker ID。
+    std::vector<std::string> pool = db.getAllJokerIds();
+    std::sort(pool.begin(), pool.end());
+
+    ScanQuery query;
+    query.minSuited = options.minSuited;
+    query.minOfAKind = options.minOfAKind;
+    query.poolSize = pool.size();
+    query.shopPicks = options.shopSize * (options.rerolls + 1);
+    for (const auto& id : options.shopJokers) {
+        const auto it = std::lower_bound(pool.begin(), pool.end(), id);
+        if (it == pool.end() || *it != id) {
+            std::cerr << "[Fatal] Unknown joker id: " << id << std::endl;
+            return 1;
+        }
+        // 命中集合用 64 位掩码记录，只支持池中前 64 个 Joker。
+        if (it - pool.begin() >= 64) {
+            std::cerr << "[Fatal] Joker id out of scan range: " << id << std::endl;
+            return 1;
+        }
+        query.shopJokers.push_back(static_cast<std::size_t>(it - pool.begin()));
+    }
+
+    const unsigned threads = options.threads != 0
+        ? options.threads
+        : std::max(1u, std::thread::hardware_concurrency());
+    auto buffers = std::make_unique<WorkerBuffer[]>(threads);
+
+    const std::uint64_t chunks = (options.count + CHUNK_SEEDS - 1) / CHUNK_SEEDS;
+    const auto start = std::chrono::steady_clock::now();
+    WorkStealing::ParallelFor(static_cast<std::size_t>(chunks), threads, [&](std::size_t chunk, unsigned worker) {
+        const std::uint64_t begin = options.from + chunk * CHUNK_SEEDS;
+        const std::uint64_t end = options.from + std::min<std::uint64_t>((chunk + 1) * CHUNK_SEEDS, options.count);
+        auto& seeds = buffers[worker].seeds;
+        std::array<Hand, SHUFFLE_BATCH> hands;
+        for (std::uint64_t base = begin; base < end; base += SHUFFLE_BATCH) {
+            const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(SHUFFLE_BATCH, end - base));
+            openingHands(base, count, hands);
+            for (std::size_t i = 0; i < count; ++i) {
+                // 先做更便宜且通常更严格的手牌谓词。
+                if (matchesHand(query, hands[i]) && matchesShop(query, base + i)) seeds.push_back(base + i);
+            }
+        }
+    });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<std::uint64_t> matches;
+    for (unsigned w = 0; w < threads; ++w) {
+        matches.insert(matches.end(), buffers[w].seeds.begin(), buffers[w].seeds.end());
+    }
+    std::sort(matches.begin(), matches.end());
+
+    std::ofstream out(options.outPath);
+    if (!out.is_open()) {
+        std::cerr << "[Error] Failed to open " << options.outPath << std::endl;
+        return 1;
+    }
+    for (const std::uint64_t seed : matches) out << seed << '\n';
+
+    const double scanned = static_cast<double>(options.count);
+    std::cout << "scanned=" << options.count
+              << " threads=" << threads
+              << " matches=" << matches.size()
+              << " seeds_per_sec=" << (seconds > 0 ? scanned / seconds : 0.0)
+              << " seeds_per_sec_per_thread=" << (seconds > 0 ? scanned / seconds / threads : 0.0)
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,1413 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Game/Core/PackedDeck.hpp"
+#include "Game/Sim/BatchShuffle.hpp"
+#include "Game/Sim/BlindSolver.hpp"
+#include "Game/Sim/DiscardAdvisor.hpp"
+#include "Game/Sim/MctsAdvisor.hpp"
+#include "Game/Sim/ReplayRunner.hpp"
+#include "Game/Sim/RunSimulator.hpp"
+#include "Game/Sim/SimPolicy.hpp"
+#include "Game/Sim/SuitIsomorphism.hpp"
+#include "Game/Systems/DeckOdds.hpp"
+#include "Game/Systems/GameDatabase.hpp"
+#include "Game/Systems/HandEvaluator.hpp"
+#include "Game/Systems/ScoreTrace.hpp"
+#include "Game/Systems/ScoringManager.hpp"
+
+// 全局分配计数，供 --check-alloc 确认结算热路径不触碰堆。
+static std::atomic<long long> g_heapAllocations{0};
+
+void* operator new(std::size_t size) {
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+// 不内联，否则 GCC 会把内联后的 free 与调用方的 new 表达式配对并误报 -Wmismatched-new-delete。
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct CliOptions {
+    int runs = 1000;
+    std::uint64_t seed = 1;
+    int maxRounds = 24;
+    std::string dataDir = "assets/data";
+    std::string replayPath;
+    bool verbose = false;
+    bool benchClone = false;
+    bool benchOdds = false;
+    bool benchDiscard = false;
+    bool benchShuffle = false;
+    bool benchEval = false;
+    bool checkExpr = false;
+    bool checkEval = false;
+    bool checkAlloc = false;
+    bool checkTrace = false;
+    int maxDiscard = 3;            // --bench-discard 考虑的最大弃牌张数
+    long long mctsIterations = 0;  // > 0 时盲注中改用 MCTS 决策
+    bool solve = false;            // 盲注开局时用精确求解器给出整盲注方案
+    unsigned threads = 0;          // 求解器线程数，0 表示使用硬件并发数
+    long long nodeLimit = 50000;   // 每个盲注的求解节点上限，0 表示不限；无法过关的盲注可能要搜索极多节点
+    long long timeLimitMs = 0;     // 每个盲注的求解时间上限（毫秒），0 表示不限
+};
+
+void printUsage() {
+    std::cout << "Usage: balatro-sim [--runs N] [--seed S] [--rounds R] [--data DIR] [--mcts ITER | --solve [--threads T] [--node-limit N] [--time-ms T]] [--verbose]\n"
+              << "       balatro-sim --replay FILE [--runs N] [--data DIR]\n"
+              << "       balatro-sim --bench-clone [--runs N] [--seed S] [--data DIR]\n"
+              << "       balatro-sim --bench-odds [--runs N] [--seed S] [--data DIR]\n"
+              << "       balatro-sim --bench-discard [--runs N] [--seed S] [--max-discard K] [--threads T] [--data DIR]\n"
+              << "       balatro-sim --bench-shuffle [--runs N] [--seed S] [--data DIR]\n"
+              << "       balatro-sim --bench-eval [--runs N] [--seed S] [--data DIR]\n"
+              << "       balatro-sim --check-expr [--runs N] [--seed S] [--data DIR]\n"
+              << "       balatro-sim --check-eval [--data DIR]\n"
+              << "       balatro-sim --check-alloc [--runs N] [--seed S] [--data DIR]\n"
+              << "       balatro-sim --check-trace [--runs N] [--seed S] [--data DIR] [--verbose]\n"
+              << "  Plays N headless runs with the greedy policy (or MCTS / the exact solver for blinds), seeds S..S+N-1;\n"
+              << "  a solve that hits --node-limit (default 50000, 0 = none) or --time-ms leaves its blind to the greedy policy,\n"
+              << "  re-executes a recorded replay N times at full speed,\n"
+              << "  times N snapshot clones of a mid-run state,\n"
+              << "  checks exact draw odds against N sampled draws per query and times them,\n"
+              << "  checks the exact discard advisor against N sampled draws and times it,\n"
+              << "  checks batched shuffles of N*64 decks against Deck::shuffle and times each path,\n"
+              << "  checks batched hand classification of N*1000 hands against Classify and times it,\n"
+              << "  checks N*200 random plays of built-in jokers against their expression rewrites,\n"
+              << "  checks every 1-5 card hand against the reference sort-and-count evaluator,\n"
+              << "  checks that N*100 plays and discards per joker lineup score without heap allocation,\n"
+              << "  or replays N*100 score traces per joker lineup against the summaries (--verbose prints one per lineup).\n";
+}
+
+bool parseArgs(int argc, char** argv, CliOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--runs" && hasValue) {
+            options.runs = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rounds" && hasValue) {
+            options.maxRounds = std::atoi(argv[++i]);
+        } else if (arg == "--data" && hasValue) {
+            options.dataDir = argv[++i];
+        } else if (arg == "--replay" && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (arg == "--mcts" && hasValue) {
+            options.mctsIterations = std::atoll(argv[++i]);
+        } else if (arg == "--solve") {
+            options.solve = true;
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--node-limit" && hasValue) {
+            options.nodeLimit = std::atoll(argv[++i]);
+        } else if (arg == "--time-ms" && hasValue) {
+            options.timeLimitMs = std::atoll(argv[++i]);
+        } else if (arg == "--bench-clone") {
+            options.benchClone = true;
+        } else if (arg == "--bench-odds") {
+            options.benchOdds = true;
+        } else if (arg == "--bench-discard") {
+            options.benchDiscard = true;
+        } else if (arg == "--bench-shuffle") {
+            options.benchShuffle = true;
+        } else if (arg == "--bench-eval") {
+            options.benchEval = true;
+        } else if (arg == "--check-expr") {
+            options.checkExpr = true;
+        } else if (arg == "--check-eval") {
+            options.checkEval = true;
+        } else if (arg == "--check-trace") {
+            options.checkTrace = true;
+        } else if (arg == "--check-alloc") {
+            options.checkAlloc = true;
+        } else if (arg == "--max-discard" && hasValue) {
+            options.maxDiscard = std::atoi(argv[++i]);
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else {
+            return false;
+        }
+    }
+    return options.runs > 0 && options.maxRounds > 0;
+}
+
+/**
+ * 全速重复回放同一份录像，用真实对局衡量规则引擎吞吐。
+ *
+ * @param db 数据仓库
+ * @param options 命令行参数
+ * @return 进程退出码
+ */
+int runReplay(const GameDatabase& db, const CliOptions& options) {
+    Replay replay;
+    std::string error;
+    if (!ReplayFormat::Load(options.replayPath, replay, error)) {
+        std::cerr << "[Fatal] " << error << std::endl;
+        return 1;
+    }
+
+    const SimConfig config = ReplayRunner::ConfigFor(replay);
+    const auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < options.runs; ++run) {
+        RunSimulator sim(db, config);
+        const std::size_t applied = ReplayRunner::Run(sim, replay);
+        if (applied != replay.actions.size()) {
+            std::cerr << "[Error] Replay diverged at action " << applied << std::endl;
+            return 1;
+        }
+        if (run == 0 || options.verbose) {
+            std::cout << "seed=" << replay.seed
+                      << " actions=" << applied
+                      << " rounds=" << sim.roundsCleared()
+                      << " score=" << sim.context().currentScore
+                      << " money=" << sim.context().money
+                      << " jokers=" << sim.jokers().size() << '\n';
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double actions = static_cast<double>(replay.actions.size()) * options.runs;
+    std::cout << "replays=" << options.runs
+              << " actions_per_sec=" << (seconds > 0 ? actions / seconds : 0.0)
+              << std::endl;
+    return 0;
+}
+
+/**
+ * 把一局推进到结束：盲注中由 MCTS 决策，商店沿用贪心策略。
+ *
+ * 单线程且只按迭代数截止，结果与种子一一对应。
+ *
+ * @param db 数据仓库
+ * @param sim 模拟器
+ * @param iterations 每次决策的迭代数
+ * @return 本局执行的步数；出现非法操作时返回 -1
+ */
+long long playOutMcts(const GameDatabase& db, RunSimulator& sim, long long iterations) {
+    MctsConfig config;
+    config.timeBudgetMs = 0;
+    config.maxIterations = iterations;
+    config.threads = 1;
+    config.seed = sim.config().seed;
+
+    GameStateSnapshot snapshot;
+    long long steps = 0;
+    while (!sim.finished()) {
+        SimAction action = SimPolicy::Greedy(sim);
+        if (sim.context().state == GameState::Run) {
+            if (!sim.capture(snapshot)) {
+                std::cerr << "[Error] State exceeds snapshot capacity" << std::endl;
+                return -1;
+            }
+            const MctsDecision decision = MctsAdvisor::Decide(db, snapshot, config);
+            if (!decision.choices.empty()) action = decision.action;
+        }
+        if (!sim.step(action)) return -1;
+        ++config.seed;
+        ++steps;
+    }
+    return steps;
+}
+
+/**
+ * 求解器统计。
+ */
+struct SolveStats {
+    long long blinds = 0;
+    long long cleared = 0;
+    long long handsUsed = 0;
+    long long nodes = 0;
+    long long aborted = 0;  // 触及节点或时间上限、改由贪心策略完成的盲注
+    double seconds = 0.0;
+};
+
+/**
+ * 把一局推进到结束：每个盲注开局时精确求解并照方案执行，商店沿用贪心策略。
+ *
+ * 方案在真实模拟器中逐步执行，求解器判定能过关而实际未过关即视为错误。
+ * 求解触及上限时不给出方案，整个盲注交给贪心策略。
+ *
+ * @param db 数据仓库
+ * @param sim 模拟器
+ * @param config 求解器配置
+ * @param stats 累计统计
+ * @return 本局执行的步数；出现非法操作或方案与模拟不一致时返回 -1
+ */
+long long playOutSolver(const GameDatabase& db, RunSimulator& sim, const SolverConfig& config, SolveStats& stats) {
+    GameStateSnapshot snapshot;
+    long long steps = 0;
+    while (!sim.finished()) {
+        if (sim.context().state != GameState::Run) {
+            if (!sim.step(SimPolicy::Greedy(sim))) return -1;
+            ++steps;
+            continue;
+        }
+
+        if (!sim.capture(snapshot)) {
+            std::cerr << "[Error] State exceeds snapshot capacity" << std::endl;
+            return -1;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const SolverResult result = BlindSolver::Solve(db, snapshot, config);
+        stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ++stats.blinds;
+        stats.nodes += result.nodes;
+        if (!result.exhaustive) ++stats.aborted;
+
+        const int roundsBefore = sim.roundsCleared();
+        for (const SimAction& action : result.plan) {
+            if (!sim.step(action)) return -1;
+            ++steps;
+        }
+        if (result.cleared) {
+            if (sim.roundsCleared() == roundsBefore) return -1;
+            ++stats.cleared;
+            stats.handsUsed += result.handsUsed;
+            continue;
+        }
+        // 无法过关时方案已打出最高分，剩余操作交给贪心策略结束本盲注。
+        while (!sim.finished() && sim.context().state == GameState::Run && sim.roundsCleared() == roundsBefore) {
+            if (!sim.step(SimPolicy::Greedy(sim))) return -1;
+            ++steps;
+        }
+    }
+    return steps;
+}
+
+/**
+ * 计时单次操作的平均纳秒数。
+ *
+ * @param iterations 重复次数
+ * @param fn 被测操作
+ * @return 平均耗时
+ */
+template <typename Fn>
+double nanosPerCall(int iterations, Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn(i);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+/**
+ * 测量树搜索常用的三种克隆开销：快照按值复制、从模拟器导出、恢复到模拟器。
+ *
+ * @param db 数据仓库
+ * @param options 命令行参数
+ * @return 进程退出码
+ */
+int runCloneBench(const GameDatabase& db, const CliOptions& options) {
+    SimConfig config;
+    config.seed = options.seed;
+    config.maxRounds = options.maxRounds;
+    RunSimulator sim(db, config);
+
+    // 推进到第一次进商店后的下一盲注，使快照带有 Joker 与消耗过的牌堆。
+    while (!sim.finished() && sim.roundsCleared() < 2) {
+        if (!sim.step(SimPolicy::Greedy(sim))) return 1;
+    }
+
+    GameStateSnapshot snapshot;
+    if (!sim.capture(snapshot)) {
+        std::cerr << "[Error] State exceeds snapshot capacity" << std::endl;
+        return 1;
+    }
+    std::vector<GameStateSnapshot> copies(64);
+
+    const int iterations = std::max(options.runs, 1) * 1000;
+    const double copyNs = nanosPerCall(iterations, [&](int i) {
+        copies[static_cast<std::size_t>(i) & 63] = snapshot;
+    });
+    const double captureNs = nanosPerCall(iterations, [&](int i) {
+        (void)sim.capture(copies[static_cast<std::size_t>(i) & 63]);
+    });
+    const double restoreNs = nanosPerCall(iterations, [&](int) {
+        sim.restore(snapshot);
+    });
+
+    // 增量维护的键必须与按快照全量重算的键一致，否则置换表会把不同局面混为一谈。
+    if (sim.zobrist() != snapshot.zobrist()) {
+        std::cerr << "[Error] Incremental Zobrist key differs from snapshot key" << std::endl;
+        return 1;
+    }
+    volatile std::uint64_t keySink = 0;
+    const double keyNs = nanosPerCall(iterations, [&](int) { keySink = sim.zobrist(); });
+    const double rehashNs = nanosPerCall(iterations, [&](int) { keySink = snapshot.zobrist(); });
+
+    // 把自由花色轮换一格后，规范键必须不变。
+    const SuitIsomorphism::SuitMask pinned = SuitIsomorphism::PinnedSuits(sim.effectPipeline());
+    SuitIsomorphism::SuitMap rotation;
+    int previous = -1;
+    int first = -1;
+    for (int s = 0; s < SuitIsomorphism::SUIT_COUNT; ++s) {
+        if (pinned & (1u << s)) continue;
+        if (previous >= 0) rotation.to[static_cast<std::size_t>(previous)] = static_cast<Suit>(s);
+        if (first < 0) first = s;
+        previous = s;
+    }
+    if (previous >= 0) rotation.to[static_cast<std::size_t>(previous)] = static_cast<Suit>(first);
+    GameStateSnapshot rotated = snapshot;
+    SuitIsomorphism::Apply(rotation, rotated);
+    if (SuitIsomorphism::CanonicalZobrist(rotated, pinned) != SuitIsomorphism::CanonicalZobrist(snapshot, pinned)) {
+        std::cerr << "[Error] Canonical key changed under a free suit permutation" << std::endl;
+        return 1;
+    }
+    const double canonicalNs = nanosPerCall(iterations, [&](int) {
+        keySink = SuitIsomorphism::CanonicalZobrist(snapshot, pinned);
+    });
+
+    // 紧凑牌堆与 Deck 用同一随机流洗牌后，抽牌顺序、键与张数统计必须一致。
+    Deck deck;
+    deck.setRankChipProvider([&db](Rank rank) { return db.getRankChips(rank); });
+    PackedDeck packed(PackedDeck::SnapshotChips([&db](Rank rank) { return db.getRankChips(rank); }));
+    for (int i = 0; i < 64; ++i) {
+        RngStream a(options.seed + static_cast<std::uint64_t>(i), 0xDECC);
+        RngStream b(options.seed + static_cast<std::uint64_t>(i), 0xDECC);
+        deck.initStandardDeck();
+        deck.shuffle(a);
+        packed.initStandardDeck();
+        packed.shuffle(b);
+        for (int drawn = 0; drawn < i % 40; ++drawn) {
+            const auto x = deck.draw();
+            const auto y = packed.draw();
+            if (x->suit != y->suit || x->rank != y->rank || x->baseChips != y->baseChips) {
+                std::cerr << "[Error] PackedDeck draw order differs from Deck" << std::endl;
+                return 1;
+            }
+        }
+        if (deck.zobrist() != packed.zobrist() || deck.counts().ranks != packed.counts().ranks ||
+            deck.counts().suits != packed.counts().suits) {
+            std::cerr << "[Error] PackedDeck key or counts differ from Deck" << std::endl;
+            return 1;
+        }
+    }
+    RngStream deckRng(options.seed, 0xDECC);
+    const double deckResetNs = nanosPerCall(iterations, [&](int) {
+        deck.initStandardDeck();
+        deck.shuffle(deckRng);
+    });
+    const double packedResetNs = nanosPerCall(iterations, [&](int) {
+        packed.initStandardDeck();
+        packed.shuffle(deckRng);
+    });
+    std::vector<Deck> deckCopies(64);
+    std::vector<PackedDeck> packedCopies(64);
+    const double deckCopyNs = nanosPerCall(iterations, [&](int i) {
+        deckCopies[static_cast<std::size_t>(i) & 63] = deck;
+    });
+    const double packedCopyNs = nanosPerCall(iterations, [&](int i) {
+        packedCopies[static_cast<std::size_t>(i) & 63] = packed;
+    });
+
+    // MCTS 确定化的两条路径：洗乱快照牌堆后恢复，或洗乱紧凑牌堆后随快照恢复。
+    // 同一随机流下恢复出的牌序与键必须一致。
+    PackedDeck rootDeck(PackedDeck::SnapshotChips([&db](Rank rank) { return db.getRankChips(rank); }));
+    for (const PackedCard card : snapshot.deck) {
+        if (!rootDeck.addCard(card.suit(), card.rank())) {
+            std::cerr << "[Error] Snapshot deck is not representable as a PackedDeck" << std::endl;
+            return 1;
+        }
+    }
+    GameStateSnapshot scratch;
+    PackedDeck shuffled;
+    const auto determinizeSnapshot = [&](RngStream& rng) {
+        scratch = snapshot;
+        for (std::size_t i = scratch.deck.size(); i > 1; --i) {
+            std::swap(scratch.deck[i - 1], scratch.deck[rng.uniform(i)]);
+        }
+        sim.restore(scratch);
+    };
+    const auto determinizePacked = [&](RngStream& rng) {
+        shuffled = rootDeck;
+        shuffled.shuffle(rng);
+        sim.restore(snapshot, &shuffled);
+    };
+    RngStream snapshotRng(options.seed, 0xD37);
+    RngStream packedRng(options.seed, 0xD37);
+    for (int i = 0; i < 64; ++i) {
+        determinizeSnapshot(snapshotRng);
+        const std::vector<CardData> expected(sim.context().deck.cards().begin(), sim.context().deck.cards().end());
+        const std::uint64_t expectedKey = sim.zobrist();
+        determinizePacked(packedRng);
+        const auto actual = sim.context().deck.cards();
+        const bool sameOrder = std::equal(expected.begin(), expected.end(), actual.begin(), actual.end(),
+            [](const CardData& x, const CardData& y) {
+                return x.suit == y.suit && x.rank == y.rank && x.baseChips == y.baseChips;
+            });
+        if (!sameOrder || sim.zobrist() != expectedKey) {
+            std::cerr << "[Error] PackedDeck determinization differs from the snapshot path" << std::endl;
+            return 1;
+        }
+    }
+    const double determinizeSnapshotNs = nanosPerCall(iterations, [&](int) { determinizeSnapshot(snapshotRng); });
+    const double determinizePackedNs = nanosPerCall(iterations, [&](int) { determinizePacked(packedRng); });
+
+    std::cout << "snapshot_bytes=" << sizeof(GameStateSnapshot)
+              << " deck=" << snapshot.deck.size()
+              << " hand=" << snapshot.hand.size()
+              << " jokers=" << snapshot.jokers.size()
+              << " copy_ns=" << copyNs
+              << " capture_ns=" << captureNs
+              << " restore_ns=" << restoreNs
+              << " zobrist_ns=" << keyNs
+              << " rehash_ns=" << rehashNs
+              << " canonical_ns=" << canonicalNs
+              << " deck_reset_ns=" << deckResetNs
+              << " packed_reset_ns=" << packedResetNs
+              << " deck_copy_ns=" << deckCopyNs
+              << " packed_copy_ns=" << packedCopyNs
+              << " determinize_snapshot_ns=" << determinizeSnapshotNs
+              << " determinize_packed_ns=" << determinizePackedNs
+              << std::endl;
+    return 0;
+}
+
+/**
+ * 判断“手牌 + 抽到的牌”是否满足抽牌目标，供抽样核对精确概率。
+ */
+bool reachesTarget(const std::vector<CardSnapshot>& cards, const DrawQuery& query) {
+    std::array<int, 15> ranks{};
+    std::array<int, 5> suits{};
+    for (const CardSnapshot& card : cards) {
+        ++ranks[static_cast<std::size_t>(card.rank)];
+        ++suits[static_cast<std::size_t>(card.suit)];
+    }
+    switch (query.target) {
+        case DrawTarget::Flush:
+            return std::any_of(suits.begin(), suits.begin() + 4, [](int c) { return c >= 5; });
+        case DrawTarget::OfAKind:
+            return *std::max_element(ranks.begin(), ranks.end()) >= query.count;
+        case DrawTarget::FullHouse: {
+            int trips = 0;
+            int pairs = 0;
+            for (int c : ranks) {
+                if (c >= 3) ++trips;
+                else if (c == 2) ++pairs;
+            }
+            return trips >= 2 || (trips >= 1 && pairs >= 1);
+        }
+        case DrawTarget::Straight: {
+            ranks[1] = ranks[14];  // A 可作 1
+            int run = 0;
+            for (int r = 1; r <= 14; ++r) {
+                run = ranks[static_cast<std::size_t>(r)] > 0 ? run + 1 : 0;
+                if (run >= 5) return true;
+            }
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * 在开局局面上核对精确抽牌概率并计时。
+ *
+ * 每个查询与 N 次随机抽样的频率比较，误差超出 5 个标准差即判定失败。
+ *
+ * @param db 数据仓库
+ * @param options 命令行参数
+ * @return 进程退出码
+ */
+int runOddsBench(const GameDatabase& db, const CliOptions& options) {
+    SimConfig config;
+    config.seed = options.seed;
+    RunSimulator sim(db, config);
+    const Deck& deck = sim.context().deck;
+    const std::vector<CardSnapshot>& hand = sim.hand();
+
+    std::vector<DrawQuery> queries;
+    for (int draws = 1; draws <= 5; ++draws) {
+        queries.push_back({DrawTarget::Flush, draws});
+        queries.push_back({DrawTarget::Straight, draws});
+        queries.push_back({DrawTarget::FullHouse, draws});
+        queries.push_back({DrawTarget::OfAKind, draws, 3});
+        queries.push_back({DrawTarget::OfAKind, draws, 4});
+    }
+
+    RngStream rng(options.seed, 0x0DD5);
+    std::vector<CardData> remaining(deck.cards().begin(), deck.cards().end());
+    std::vector<CardSnapshot> cards;
+    double maxSigma = 0.0;
+    for (const DrawQuery& query : queries) {
+        DeckOdds odds;
+        const double exact = odds.probability(hand, deck, query);
+        int hits = 0;
+        for (int trial = 0; trial < options.runs; ++trial) {
+            cards.assign(hand.begin(), hand.end());
+            // 部分 Fisher-Yates：只打乱前 draws 张即得到均匀的无放回抽样。
+            for (int i = 0; i < query.draws; ++i) {
+                const std::size_t j = static_cast<std::size_t>(i) + rng.uniform(remaining.size() - static_cast<std::size_t>(i));
+                std::swap(remaining[static_cast<std::size_t>(i)], remaining[j]);
+                cards.push_back(CardSnapshot{.suit = remaining[static_cast<std::size_t>(i)].suit,
+                                             .rank = remaining[static_cast<std::size_t>(i)].rank});
+            }
+            hits += reachesTarget(cards, query) ? 1 : 0;
+        }
+        const double sampled = static_cast<double>(hits) / options.runs;
+        const double sigma = std::sqrt(std::max(exact * (1.0 - exact), 1e-12) / options.runs);
+        maxSigma = std::max(maxSigma, std::abs(sampled - exact) / sigma);
+    }
+
+    const int iterations = std::max(options.runs, 1) * 10;
+    const double coldNs = nanosPerCall(iterations, [&](int i) {
+        DeckOdds odds;
+        odds.probability(hand, deck, queries[static_cast<std::size_t>(i) % queries.size()]);
+    });
+    DeckOdds cached;
+    const double warmNs = nanosPerCall(iterations, [&](int i) {
+        cached.probability(hand, deck, queries[static_cast<std::size_t>(i) % queries.size()]);
+    });
+
+    std::cout << "queries=" << queries.size()
+              << " samples=" << options.runs
+              << " max_sigma=" << maxSigma
+              << " cold_us=" << coldNs / 1000.0
+              << " cached_us=" << warmNs / 1000.0
+              << std::endl;
+    if (maxSigma > 5.0) {
+        std::cerr << "[Error] Exact draw odds disagree with sampling" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * 用抽样核对精确弃牌期望，并测量首次计算与命中缓存的耗时。
+ *
+ * @param db 数据仓库
+ * @param options 命令行参数
+ * @return 进程退出码
+ */
+int runDiscardBench(const GameDatabase& db, const CliOptions& options) {
+    SimConfig config;
+    config.seed = options.seed;
+    config.maxRounds = options.maxRounds;
+    RunSimulator sim(db, config);
+
+    // 与 --bench-clone 相同，推进到带 Joker 的盲注，使花色效果参与枚举。
+    while (!sim.finished() && sim.roundsCleared() < 2) {
+        if (!sim.step(SimPolicy::Greedy(sim))) return 1;
+    }
+    const Deck& deck = sim.context().deck;
+    const std::vector<CardSnapshot>& hand = sim.hand();
+
+    DiscardConfig discard;
+    discard.maxDiscard = options.maxDiscard;
+    discard.threads = options.threads;
+    discard.need = sim.context().targetScore - sim.context().currentScore;
+
+    DiscardAdvisor advisor;
+    auto start = std::chrono::steady_clock::now();
+    const DiscardAdvice advice = advisor.advise(hand, deck, &sim.effectPipeline(), discard);
+    const double coldMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    advisor.advise(hand, deck, &sim.effectPipeline(), discard);
+    const double cachedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (advice.options.empty()) {
+        std::cerr << "[Error] No discard options for this hand" << std::endl;
+        return 1;
+    }
+
+    // 对最优方案做无放回抽样，样本均值应落在精确期望附近。
+    const DiscardEv& best = advice.options.front();
+    std::vector<CardSnapshot> kept;
+    for (std::size_t i = 0; i < hand.size(); ++i) {
+        if (((best.cardMask >> i) & 1) == 0) kept.push_back(hand[i]);
+    }
+    const int draws = std::min(GameContext::HAND_SIZE_LIMIT - static_cast<int>(kept.size()), deck.getRemainingCount());
+    RngStream rng(options.seed, 0xD15C);
+    std::vector<CardData> remaining(deck.cards().begin(), deck.cards().end());
+    std::vector<CardSnapshot> cards;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    for (int trial = 0; trial < options.runs; ++trial) {
+        cards = kept;
+        for (int i = 0; i < draws; ++i) {
+            const std::size_t j = static_cast<std::size_t>(i) + rng.uniform(remaining.size() - static_cast<std::size_t>(i));
+            std::swap(remaining[static_cast<std::size_t>(i)], remaining[j]);
+            const CardData& card = remaining[static_cast<std::size_t>(i)];
+            cards.push_back(CardSnapshot{.suit = card.suit, .rank = card.rank, .chips = card.baseChips});
+        }
+        const auto plays = HandEvaluator::EnumerateBestPlays(cards, &sim.effectPipeline(), 1);
+        const double value = plays.empty() ? 0.0 : static_cast<double>(plays.front().final_score);
+        sum += value;
+        sumSquares += value * value;
+    }
+    const double mean = sum / options.runs;
+    const double variance = std::max(sumSquares / options.runs - mean * mean, 1e-12);
+    const double sigma = std::abs(mean - best.expectedScore) / std::sqrt(variance / options.runs);
+
+    std::cout << "options=" << advice.options.size()
+              << " evaluations=" << advice.evaluations
+              << " best_mask=" << best.cardMask
+              << " best_ev=" << best.expectedScore
+              << " clear=" << best.clearChance
+              << " keep=" << advice.keepScore
+              << " sampled=" << mean
+              << " sigma=" << sigma
+              << " cold_ms=" << coldMs
+              << " cached_us=" << cachedUs
+              << std::endl;
+    if (sigma > 5.0) {
+        std::cerr << "[Error] Exact discard EV disagrees with sampling" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * 核对批量洗牌的标量与 SIMD 路径都与逐副 PackedDeck::shuffle 逐位一致，并测量三者吞吐。
+ *
+ * @param options 命令行参数
+ * @return 进程退出码
+ */
+int runShuffleBench(const CliOptions& options) {
+    const std::size_t decks = static_cast<std::size_t>(options.runs) * 64;
+    std::vector<RngStream> initial(decks);
+    for (std::size_t i = 0; i < decks; ++i) {
+        initial[i] = RngStream(options.seed + i, RngService::StreamNumber(RngStreamId::Deck));
+        // 错开起始位置，覆盖流位置不按 Philox 块对齐的情况。
+        initial[i].discard(i % 7);
+    }
+
+    std::vector<BatchShuffle::Permutation> simd(decks);
+    std::vector<BatchShuffle::Permutation> scalar(decks);
+    for (const std::size_t draws : {BatchShuffle::DECK_SIZE, std::size_t{8}}) {
+        std::vector<RngStream> a = initial;
+        std::vector<RngStream> b = initial;
+        std::vector<RngStream> c = initial;
+        BatchShuffle::Shuffle(a, simd, draws);
+        BatchShuffle::ShuffleScalar(b, scalar, draws);
+        for (std::size_t i = 0; i < decks; ++i) {
+            PackedDeck deck;
+            deck.initStandardDeck();
+            deck.shuffle(c[i], draws);
+            const auto order = deck.order();
+            if (!std::equal(order.begin(), order.end(), simd[i].begin()) || simd[i] != scalar[i] ||
+                a[i].position() != c[i].position() || b[i].position() != c[i].position()) {
+                std::cerr << "[Error] Batched shuffle differs from Deck::shuffle at deck " << i
+                          << " draws=" << draws << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::vector<RngStream> streams = initial;
+    const auto perDeck = [&](auto&& fn) {
+        streams = initial;
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / decks;
+    };
+    PackedDeck deck;
+    const double stepwiseNs = perDeck([&] {
+        for (std::size_t i = 0; i < decks; ++i) {
+            deck.initStandardDeck();
+            deck.shuffle(streams[i]);
+        }
+    });
+    const double scalarNs = perDeck([&] { BatchShuffle::ShuffleScalar(streams, scalar); });
+    const double simdNs = perDeck([&] { BatchShuffle::Shuffle(streams, simd); });
+
+    std::cout << "decks=" << decks
+              << " simd=" << (BatchShuffle::SimdAvailable() ? "avx2" : "none")
+              << " stepwise_ns=" << stepwiseNs
+              << " batch_scalar_ns=" << scalarNs
+              << " batch_simd_ns=" << simdNs
+              << std::endl;
+    return 0;
+}
+
+bool sameSummary(const ScoreSummary& a, const ScoreSummary& b) {
+    return a.final_score == b.final_score && a.final_chips == b.final_chips &&
+           a.final_mult == b.final_mult && a.dollars == b.dollars;
+}
+
+/**
+ * 核对表达式 Joker 与对应内置效果的结算完全一致，并测量两者开销。
+ *
+ * 样例文件 samples/expr_jokers.json 中 ID 以 _expr 结尾的条目是同名内置 Joker 的表达式改写。
+ * 每次随机抽取编队、计分牌、手持牌与弃牌，分别用内置与表达式编队结算出牌和弃牌，
+ * 任一字段不同即失败。
+ *
+ * @param db 数据仓库
+ * @param options 命令行参数
+ * @return 进程退出码
+ */
+int runExprCheck(const GameDatabase& db, const CliOptions& options) {
+    constexpr std::string_view SUFFIX = "_expr";
+    constexpr std::size_t MAX_LINEUP = 5;
+    constexpr std::size_t MAX_SCORING = 5;
+    constexpr std::size_t MAX_HELD = 3;
+
+    GameDatabase samples;
+    const std::string samplePath = options.dataDir + "/samples/expr_jokers.json";
+    if (!samples.loadJokers(samplePath)) {
+        std::cerr << "[Fatal] Failed to load " << samplePath << std::endl;
+        return 1;
+    }
+
+    std::vector<std::shared_ptr<IEffect>> builtins;
+    std::vector<std::shared_ptr<IEffect>> scripted;
+    for (const std::string& id : samples.getAllJokerIds()) {
+        if (id.size() <= SUFFIX.size() || !id.ends_with(SUFFIX)) continue;
+        auto builtin = db.createJokerEffect(id.substr(0, id.size() - SUFFIX.size()));
+        auto script = samples.createJokerEffect(id);
+        if (!builtin || !builtin->Builtin() || !script) continue;
+        builtins.push_back(std::move(builtin));
+        scripted.push_back(std::move(script));
+    }
+    if (builtins.empty()) {
+        std::cerr << "[Fatal] No expression rewrites of built-in jokers in " << samplePath << std::endl;
+        return 1;
+    }
+
+    std::vector<CardSnapshot> deck;
+    for (int s = 0; s < 4; ++s) {
+        for (int r = static_cast<int>(Rank::Two); r <= static_cast<int>(Rank::Ace); ++r) {
+            deck.push_back(CardSnapshot{.suit = static_cast<Suit>(s), .rank = static_cast<Rank>(r),
+                                        .chips = db.getRankChips(static_cast<Rank>(r))});
+        }
+    }
+
+    /**
+     * 一次随机出牌：同一编队的内置与表达式两条流水线，以及计分牌、手持牌与弃牌。
+     */
+    struct Trial {
+        EffectPipeline builtin;
+        EffectPipeline scripted;
+        int baseChips = 0;
+        int baseMult = 0;
+        std::vector<CardSnapshot> scoring;
+        std::vector<CardSnapshot> held;
+        std::vector<CardSnapshot> discarded;
+    };
+
+    RngStream rng(options.seed, 0xE4B2);
+    const auto deal = [&](Trial& trial) {
+        trial.builtin.clear();
+        trial.scripted.clear();
+        const std::size_t lineup = 1 + rng.uniform(MAX_LINEUP);
+        for (std::size_t i = 0; i < lineup; ++i) {
+            const std::size_t pick = rng.uniform(builtins.size());
+            trial.builtin.add(builtins[pick].get());
+            trial.scripted.add(scripted[pick].get());
+        }
+        trial.baseChips = 5 + static_cast<int>(rng.uniform(100));
+        trial.baseMult = 1 + static_cast<int>(rng.uniform(8));
+
+        const std::size_t scoring = 1 + rng.uniform(MAX_SCORING);
+        const std::size_t held = rng.uniform(MAX_HELD + 1);
+        for (std::size_t i = 0; i < scoring + held; ++i) {
+            std::swap(deck[i], deck[i + rng.uniform(deck.size() - i)]);
+        }
+        trial.scoring.assign(deck.begin(), deck.begin() + static_cast<std::ptrdiff_t>(scoring));
+        trial.held.assign(deck.begin() + static_cast<std::ptrdiff_t>(scoring),
+                          deck.begin() + static_cast<std::ptrdiff_t>(scoring + held));
+        trial.discarded.assign(deck.begin(), deck.begin() + static_cast<std::ptrdiff_t>(1 + rng.uniform(MAX_SCORING)));
+    };
+
+    const int trials = options.runs * 200;
+    Trial trial;
+    for (int i = 0; i < trials; ++i) {
+        deal(trial);
+        const ScoreSummary playBuiltin = ScoringManager::CalculateFinalScore(
+            trial.baseChips, trial.baseMult, trial.scoring, trial.held, &trial.builtin);
+        const ScoreSummary playScripted = ScoringManager::CalculateFinalScore(
+            trial.baseChips, trial.baseMult, trial.scoring, trial.held, &trial.scripted);
+        const ScoreSummary discardBuiltin = ScoringManager::CalculateDiscardEffect(trial.discarded, &trial.builtin);
+        const ScoreSummary discardScripted = ScoringManager::CalculateDiscardEffect(trial.discarded, &trial.scripted);
+        if (!sameSummary(playBuiltin, playScripted) || !sameSummary(discardBuiltin, discardScripted)) {
+            std::cerr << "[Error] Expression jokers differ from built-ins at trial " << i
+                      << ": play " << playBuiltin.final_score << " vs " << playScripted.final_score
+                      << ", discard $" << discardBuiltin.dollars << " vs $" << discardScripted.dollars << std::endl;
+            return 1;
+        }
+    }
+
+    // 计时用一组固定样本循环，排除随机生成的开销。
+    std::vector<Trial> sample(256);
+    for (Trial& t : sample) deal(t);
+    const auto timeWith = [&](EffectPipeline Trial::*pipeline) {
+        volatile long long sink = 0;
+        const double ns = nanosPerCall(trials, [&](int i) {
+            const Trial& t = sample[static_cast<std::size_t>(i) % sample.size()];
+            sink = ScoringManager::CalculateFinalScore(t.baseChips, t.baseMult, t.scoring, t.held, &(t.*pipeline)).final_score +
+                   ScoringManager::CalculateDiscardEffect(t.discarded, &(t.*pipeline)).dollars;
+        });
+        return ns;
+    };
+    const double builtinNs = timeWith(&Trial::builtin);
+    const double scriptedNs = timeWith(&Trial::scripted);
+
+    std::cout << "pairs=" << builtins.size()
+              << " trials=" << trials
+              << " mismatches=0"
+              << " builtin_ns=" << builtinNs
+              << " expr_ns=" << scriptedNs
+              << std::endl;
+    return 0;
+}
+
+/**
+ * 核对 EvaluateBatch 与逐手 Classify 结果逐项一致，并测量 Evaluate、Classify 与批量分类的吞吐。
+ *
+ * 核对集合含 0~15 张、花色可为 Suit::None、允许重复的随机手牌；
+ * 计时集合为 1~5 张不重复的出牌，三条路径处理相同输入。
+ *
+ * @param options 命令行参数
+ * @return 进程退出码
+ */
+int runEvalBench(const CliOptions& options) {
+    const std::size_t count = static_cast<std::size_t>(options.runs) * 1000;
+    RngStream rng(options.seed, 0xE7A1);
+
+    std::vector<CardSnapshot> cards;
+    std::vector<PackedHand> packed(count);
+    for (PackedHand& hand : packed) {
+        cards.clear();
+        const std::size_t size = rng.uniform(PackedHand::MAX_CARDS + 1);
+        for (std::size_t i = 0; i < size; ++i) {
+            cards.push_back(CardSnapshot{.suit = static_cast<Suit>(rng.uniform(5)),
+                                         .rank = static_cast<Rank>(2 + rng.uniform(13))});
+        }
+        hand = HandEvaluator::Pack(cards);
+    }
+
+    // 出牌集合按每手 5 个槽位平铺，size 记录实际张数。
+    std::array<CardSnapshot, 52> deck{};
+    for (std::size_t i = 0; i < deck.size(); ++i) {
+        deck[i] = CardSnapshot{.suit = static_cast<Suit>(i / 13), .rank = static_cast<Rank>(2 + i % 13)};
+    }
+    constexpr std::size_t SLOTS = HandEvaluator::MAX_PLAY_CARDS;
+    std::vector<CardSnapshot> plays(count * SLOTS);
+    std::vector<std::uint8_t> playSizes(count);
+    std::vector<PackedHand> playPacked(count);
+    for (std::size_t h = 0; h < count; ++h) {
+        const std::size_t size = 1 + rng.uniform(SLOTS);
+        for (std::size_t i = 0; i < size; ++i) std::swap(deck[i], deck[i + rng.uniform(deck.size() - i)]);
+        std::copy(deck.begin(), deck.begin() + static_cast<std::ptrdiff_t>(size), plays.begin() + static_cast<std::ptrdiff_t>(h * SLOTS));
+        playSizes[h] = static_cast<std::uint8_t>(size);
+        playPacked[h] = HandEvaluator::Pack(std::span<const CardSnapshot>(plays).subspan(h * SLOTS, size));
+    }
+
+    std::vector<HandClass> batch(count);
+    for (const auto* set : {&packed, &playPacked}) {
+        HandEvaluator::EvaluateBatch(*set, batch);
+        for (std::size_t i = 0; i < count; ++i) {
+            const HandClass scalar = HandEvaluator::Classify((*set)[i]);
+            if (batch[i].type != scalar.type || batch[i].scoring_mask != scalar.scoring_mask) {
+                std::cerr << "[Error] EvaluateBatch differs from Classify at hand " << i
+                          << ": type " << static_cast<int>(batch[i].type) << " vs " << static_cast<int>(scalar.type)
+                          << ", mask " << batch[i].scoring_mask << " vs " << scalar.scoring_mask << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    const auto perHand = [&](auto&& fn) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+    };
+    volatile int sink = 0;
+    const double evaluateNs = perHand([&] {
+        for (std::size_t h = 0; h < count; ++h) {
+            const auto hand = std::span<const CardSnapshot>(plays).subspan(h * SLOTS, playSizes[h]);
+            sink = static_cast<int>(HandEvaluator::Evaluate(hand).type);
+        }
+    });
+    const double classifyNs = perHand([&] {
+        for (std::size_t h = 0; h < count; ++h) sink = HandEvaluator::Classify(playPacked[h]).scoring_mask;
+    });
+    const double batchNs = perHand([&] {
+        HandEvaluator::EvaluateBatch(playPacked, batch);
+        sink = batch.back().scoring_mask;
+    });
+
+    std::cout << "hands=" << count * 2
+              << " mismatches=0"
+              << " evaluate_ns=" << evaluateNs
+              << " classify_ns=" << classifyNs
+              << " batch_ns=" << batchNs
+              << std::endl;
+    return 0;
+}
+
+/**
+ * 参考实现中的牌型基础筹码与倍率。
+ */
+const std::map<PokerHandType, std::pair<int, int>> REFERENCE_BASE_STATS = {
+    {PokerHandType::HighCard,      {5, 1}},
+    {PokerHandType::Pair,          {10, 2}},
+    {PokerHandType::TwoPair,       {20, 2}},
+    {PokerHandType::ThreeOfAKind,  {30, 3}},
+    {PokerHandType::Straight,      {30, 4}},
+    {PokerHandType::Flush,         {35, 4}},
+    {PokerHandType::FullHouse,     {40, 4}},
+    {PokerHandType::FourOfAKind,   {60, 7}},
+    {PokerHandType::StraightFlush, {100, 8}},
+    {PokerHandType::RoyalFlush,    {100, 8}},
+};
+
+/**
+ * 参考牌型判定：排序后按点数、花色计数逐项判断，即位编码实现之前的 HandEvaluator::Evaluate。
+ *
+ * 只用于核对，不关心性能。
+ *
+ * @param hand 手牌
+ * @param scoring 输出计分牌，保持手牌中的原始顺序
+ * @return 牌型
+ */
+PokerHandType referenceEvaluate(const std::vector<CardSnapshot>& hand, std::vector<CardSnapshot>& scoring) {
+    scoring = hand;
+    if (hand.empty()) return PokerHandType::HighCard;
+
+    std::vector<CardSnapshot> sorted = hand;
+    std::sort(sorted.begin(), sorted.end(), [](const CardSnapshot& a, const CardSnapshot& b) {
+        return a.rank < b.rank;
+    });
+    std::map<Rank, int> rankCounts;
+    std::map<Suit, int> suitCounts;
+    for (const auto& c : sorted) {
+        rankCounts[c.rank]++;
+        suitCounts[c.suit]++;
+    }
+
+    const bool flush = sorted.size() >= 5 && suitCounts.size() == 1;
+    bool straight = false;
+    if (sorted.size() >= 5) {
+        straight = sorted.back().rank == Rank::Ace && sorted[0].rank == Rank::Two && sorted[1].rank == Rank::Three &&
+                   sorted[2].rank == Rank::Four && sorted[3].rank == Rank::Five;
+        if (!straight) {
+            straight = true;
+            for (std::size_t i = 0; i + 1 < sorted.size(); ++i) {
+                if (static_cast<int>(sorted[i + 1].rank) - static_cast<int>(sorted[i].rank) != 1) straight = false;
+            }
+        }
+    }
+
+    int pairs = 0;
+    int threes = 0;
+    int fours = 0;
+    for (const auto& [rank, count] : rankCounts) {
+        if (count == 2) pairs++;
+        if (count == 3) threes++;
+        if (count == 4) fours++;
+    }
+
+    const auto keepCount = [&](int count) {
+        scoring.clear();
+        for (const auto& c : hand) {
+            if (rankCounts[c.rank] == count) scoring.push_back(c);
+        }
+    };
+    if (straight && flush) {
+        return sorted.back().rank == Rank::Ace && sorted.front().rank == Rank::Ten ? PokerHandType::RoyalFlush
+                                                                                 : PokerHandType::StraightFlush;
+    }
+    if (fours > 0) {
+        keepCount(4);
+        return PokerHandType::FourOfAKind;
+    }
+    if (threes > 0 && pairs > 0) return PokerHandType::FullHouse;
+    if (flush) return PokerHandType::Flush;
+    if (straight) return PokerHandType::Straight;
+    if (threes > 0) {
+        keepCount(3);
+        return PokerHandType::ThreeOfAKind;
+    }
+    if (pairs > 0) {
+        keepCount(2);
+        return pairs >= 2 ? PokerHandType::TwoPair : PokerHandType::Pair;
+    }
+    scoring.assign(1, sorted.back());
+    return PokerHandType::HighCard;
+}
+
+/**
+ * 穷举 52 张牌的全部 1~5 张组合，核对 Evaluate 与 Classify 的牌型、基础值与计分牌都与参考实现一致。
+ *
+ * 每张牌的筹码互不相同，计分牌按筹码逐张比较即可确认顺序与归属。
+ * 组合按逆序放入手牌，避免输入恰好有序而掩盖排序相关的差异。
+ *
+ * @return 进程退出码
+ */
+int runEvalCheck() {
+    std::vector<CardSnapshot> deck;
+    for (int s = 0; s < 4; ++s) {
+        for (int r = static_cast<int>(Rank::Two); r <= static_cast<int>(Rank::Ace); ++r) {
+            deck.push_back(CardSnapshot{.suit = static_cast<Suit>(s), .rank = static_cast<Rank>(r), .chips = r * 10 + s});
+        }
+    }
+
+    std::vector<CardSnapshot> hand;
+    std::vector<CardSnapshot> expected;
+    long long hands = 0;
+    long long mismatches = 0;
+    const auto check = [&] {
+        ++hands;
+        const PokerHandType type = referenceEvaluate(hand, expected);
+        const HandResult result = HandEvaluator::Evaluate(hand);
+        const HandClass cls = HandEvaluator::Classify(HandEvaluator::Pack(hand));
+        const auto& [chips, mult] = REFERENCE_BASE_STATS.at(type);
+        bool same = result.type == type && cls.type == type &&
+                    result.base_chips == chips && result.base_mult == mult &&
+                    result.scoring_snapshots.size() == expected.size() &&
+                    static_cast<std::size_t>(std::popcount(cls.scoring_mask)) == expected.size();
+        for (std::size_t i = 0; same && i < expected.size(); ++i) {
+            same = result.scoring_snapshots[i].chips == expected[i].chips;
+        }
+        if (!same && mismatches++ < 5) {
+            std::cerr << "[Error] Hand evaluation differs:";
+            for (const auto& c : hand) std::cerr << ' ' << static_cast<int>(c.rank) << '/' << static_cast<int>(c.suit);
+            std::cerr << " expected=" << static_cast<int>(type) << " evaluate=" << static_cast<int>(result.type)
+                      << " classify=" << static_cast<int>(cls.type) << std::endl;
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::array<std::size_t, HandEvaluator::MAX_PLAY_CARDS> picks{};
+    const std::function<void(int, std::size_t)> choose = [&](int depth, std::size_t from) {
+        for (std::size_t i = from; i < deck.size(); ++i) {
+            picks[static_cast<std::size_t>(depth)] = i;
+            hand.clear();
+            for (int d = depth; d >= 0; --d) hand.push_back(deck[picks[static_cast<std::size_t>(d)]]);
+            check();
+            if (depth + 1 < HandEvaluator::MAX_PLAY_CARDS) choose(depth + 1, i + 1);
+        }
+    };
+    choose(0, 0);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "hands=" << hands
+              << " mismatches=" << mismatches
+              << " seconds=" << seconds
+              << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * 结算检查用的一组编队。
+ */
+struct ScoringLineup {
+    const char* name = "";
+    EffectPipeline pipeline;
+    std::vector<std::string> names;  // 各槽位 Joker 名称
+};
+
+/**
+ * 结算检查共用的三组编队：全部内置 Joker、样例表达式 Joker、两者混合。
+ */
+struct ScoringLineups {
+    GameDatabase samples;
+    std::vector<std::shared_ptr<IEffect>> effects;
+    std::array<ScoringLineup, 3> lineups;
+};
+
+/**
+ * 载入样例表达式 Joker 并组建三组编队。
+ *
+ * @param db 数据仓库
+ * @param options 命令行参数
+ * @param out 输出编队，效果对象由其持有
+ * @return 样例文件载入失败时返回 false
+ */
+bool loadScoringLineups(const GameDatabase& db, const CliOptions& options, ScoringLineups& out) {
+    const std::string samplePath = options.dataDir + "/samples/expr_jokers.json";
+    if (!out.samples.loadJokers(samplePath)) {
+        std::cerr << "[Fatal] Failed to load " << samplePath << std::endl;
+        return false;
+    }
+
+    auto& [builtins, scripted, mixed] = out.lineups;
+    builtins.name = "builtin";
+    scripted.name = "expr";
+    mixed.name = "mixed";
+    const auto addJoker = [&](const GameDatabase& source, const std::string& id, ScoringLineup& lineup) {
+        out.effects.push_back(source.createJokerEffect(id));
+        const JokerData* data = source.findJoker(id);
+        for (ScoringLineup* target : {&lineup, &mixed}) {
+            target->pipeline.add(out.effects.back().get());
+            target->names.push_back(data ? data->name : id);
+        }
+    };
+    for (const std::string& id : db.getAllJokerIds()) addJoker(db, id, builtins);
+    for (const std::string& id : out.samples.getAllJokerIds()) addJoker(out.samples, id, scripted);
+    return true;
+}
+
+/**
+ * 标准 52 张牌的快照，筹码取自数据仓库。
+ */
+std::array<CardSnapshot, 52> standardSnapshots(const GameDatabase& db) {
+    std::array<CardSnapshot, 52> deck{};
+    for (int s = 0; s < 4; ++s) {
+        for (int r = static_cast<int>(Rank::Two); r <= static_cast<int>(Rank::Ace); ++r) {
+            deck[static_cast<std::size_t>(s * 13 + r - 2)] =
+                CardSnapshot{.suit = static_cast<Suit>(s), .rank = static_cast<Rank>(r), .chips = db.getRankChips(static_cast<Rank>(r))};
+        }
+    }
+    return deck;
+}
+
+/**
+ * 核对出牌与弃牌结算不做堆分配。
+ *
+ * 分别用全部内置 Joker、samples/expr_jokers.json 中的全部表达式 Joker 以及两者混合组成编队，
+ * 流水线与输入缓冲在计数前准备好，只统计 CalculateFinalScore 与 CalculateDiscardEffect 期间的 operator new 调用。
+ *
+ * @param db 数据仓库
+ * @param options 命令行参数
+ * @return 进程退出码
+ */
+int runAllocCheck(const GameDatabase& db, const CliOptions& options) {
+    ScoringLineups lineups;
+    if (!loadScoringLineups(db, options, lineups)) return 1;
+    std::array<CardSnapshot, 52> deck = standardSnapshots(db);
+
+    RngStream rng(options.seed, 0xA110C);
+    const int trials = options.runs * 100;
+    bool failed = false;
+    for (const ScoringLineup& lineup : lineups.lineups) {
+        const EffectPipeline* pipeline = &lineup.pipeline;
+        long long allocations = 0;
+        long long scoreSum = 0;
+        for (int i = 0; i < trials; ++i) {
+            const std::size_t scoring = 1 + rng.uniform(HandEvaluator::MAX_PLAY_CARDS);
+            const std::size_t held = rng.uniform(4);
+            for (std::size_t k = 0; k < scoring + held; ++k) {
+                std::swap(deck[k], deck[k + rng.uniform(deck.size() - k)]);
+            }
+            const std::span<const CardSnapshot> cards(deck);
+            const long long before = g_heapAllocations.load(std::memory_order_relaxed);
+            const ScoreSummary play = ScoringManager::CalculateFinalScore(
+                10, 2, cards.first(scoring), cards.subspan(scoring, held), pipeline);
+            const ScoreSummary discard = ScoringManager::CalculateDiscardEffect(cards.first(scoring), pipeline);
+            allocations += g_heapAllocations.load(std::memory_order_relaxed) - before;
+            scoreSum += play.final_score + discard.dollars;
+        }
+        std::cout << lineup.name << ": slots=" << pipeline->slotCount()
+                  << " trials=" << trials
+                  << " allocations=" << allocations
+                  << " score_sum=" << scoreSum
+                  << std::endl;
+        if (allocations != 0) failed = true;
+    }
+    if (failed) std::cerr << "[Error] Scoring allocated on the heap" << std::endl;
+    return failed ? 1 : 0;
+}
+
+/**
+ * 按记录顺序重放追踪事件，得到与结算接口相同形式的汇总。
+ *
+ * @param events 追踪事件
+ * @return 重放结果，final_score 为重放所得筹码与倍率之积
+ */
+ScoreSummary replayTrace(std::span<const ScoreTraceEvent> events) {
+    ScoreSummary summary;
+    for (const ScoreTraceEvent& event : events) {
+        switch (event.op) {
+            case TraceOp::BaseChips:  summary.final_chips = event.delta; break;
+            case TraceOp::BaseMult:   summary.final_mult = event.delta; break;
+            case TraceOp::CardChips:
+            case TraceOp::AddChips:   summary.final_chips += event.delta; break;
+            case TraceOp::AddMult:    summary.final_mult += event.delta; break;
+            case TraceOp::XMult:      summary.final_mult = static_cast<int>(summary.final_mult * event.factor); break;
+            case TraceOp::AddDollars: summary.dollars += event.delta; break;
+        }
+    }
+    summary.final_score = static_cast<long long>(summary.final_chips) * summary.final_mult;
+    return summary;
+}
+
+bool sameEvent(const ScoreTraceEvent& a, const ScoreTraceEvent& b) {
+    return a.source_slot == b.source_slot && a.phase == b.phase && a.op == b.op &&
+           a.delta == b.delta && a.factor == b.factor;
+}
+
+/**
+ * 核对结算追踪：重放事件须得到与结算汇总相同的筹码、倍率、得分与金钱。
+ *
+ * 每次随机抽取计分牌与手持牌，在三组编队上分别结算出牌与弃牌并重放追踪；
+ * 同时用只有几条容量的小缓冲再结算一次，确认写满后只保留前缀、其余计入 dropped()，
+ * 并确认每条事件都能格式化为文本。
+ *
+ * @param db 数据仓库
+ * @param options 命令行参数，--verbose 时打印每组编队第一次出牌的追踪
+ * @return 进程退出码
+ */
+int runTraceCheck(const GameDatabase& db, const CliOptions& options) {
+    constexpr std::size_t SMALL_CAPACITY = 4;
+
+    ScoringLineups lineups;
+    if (!loadScoringLineups(db, options, lineups)) return 1;
+    std::array<CardSnapshot, 52> deck = standardSnapshots(db);
+
+    std::array<ScoreTraceEvent, 256> storage{};
+    std::array<ScoreTraceEvent, SMALL_CAPACITY> smallStorage{};
+    ScoreTrace trace(storage);
+    ScoreTrace small(smallStorage);
+
+    RngStream rng(options.seed, 0x7ACE);
+    const int trials = options.runs * 100;
+    bool failed = false;
+    for (const ScoringLineup& lineup : lineups.lineups) {
+        long long events = 0;
+        long long dropped = 0;
+        long long mismatches = 0;
+        for (int i = 0; i < trials; ++i) {
+            const std::size_t scoring = 1 + rng.uniform(HandEvaluator::MAX_PLAY_CARDS);
+            const std::size_t held = rng.uniform(4);
+            for (std::size_t k = 0; k < scoring + held; ++k) {
+                std::swap(deck[k], deck[k + rng.uniform(deck.size() - k)]);
+            }
+            const std::span<const CardSnapshot> cards(deck);
+            const auto played = cards.first(scoring);
+            const auto kept = cards.subspan(scoring, held);
+
+            // 出牌：完整缓冲重放须与汇总一致，小缓冲只保留前缀。
+            trace.clear();
+            small.clear();
+            const ScoreSummary play = ScoringManager::CalculateFinalScore(10, 2, played, kept, &lineup.pipeline, &trace);
+            (void)ScoringManager::CalculateFinalScore(10, 2, played, kept, &lineup.pipeline, &small);
+            bool ok = trace.dropped() == 0 && sameSummary(replayTrace(trace.events()), play);
+
+            const std::size_t recorded = trace.events().size();
+            const std::size_t prefix = std::min(recorded, SMALL_CAPACITY);
+            ok = ok && small.events().size() == prefix && small.dropped() == recorded - prefix;
+            for (std::size_t k = 0; ok && k < prefix; ++k) ok = sameEvent(small.events()[k], trace.events()[k]);
+            for (const ScoreTraceEvent& event : trace.events()) ok = ok && !ScoreTrace::Format(event, lineup.names).empty();
+
+            if (options.verbose && i == 0) {
+                std::cout << lineup.name << " trace (" << recorded << " events, score=" << play.final_score << "):\n";
+                for (const ScoreTraceEvent& event : trace.events()) {
+                    std::cout << "  " << ScoreTrace::Format(event, lineup.names) << '\n';
+                }
+            }
+            events += static_cast<long long>(recorded);
+            dropped += static_cast<long long>(small.dropped());
+
+            // 弃牌：只产生加成与金钱，重放得分无意义，逐字段比较其余部分。
+            trace.clear();
+            const ScoreSummary discard = ScoringManager::CalculateDiscardEffect(played, &lineup.pipeline, &trace);
+            const ScoreSummary replayed = replayTrace(trace.events());
+            ok = ok && trace.dropped() == 0 && replayed.final_chips == discard.final_chips &&
+                 replayed.final_mult == discard.final_mult && replayed.dollars == discard.dollars;
+            events += static_cast<long long>(trace.events().size());
+
+            if (!ok) ++mismatches;
+        }
+        std::cout << lineup.name << ": slots=" << lineup.pipeline.slotCount()
+                  << " trials=" << trials
+                  << " events=" << events
+                  << " small_dropped=" << dropped
+                  << " mismatches=" << mismatches
+                  << std::endl;
+        if (mismatches != 0) failed = true;
+    }
+    if (failed) std::cerr << "[Error] Score trace does not replay to the score summary" << std::endl;
+    return failed ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CliOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    GameDatabase db;
+    if (!db.loadRanks(options.dataDir + "/ranks.json") || !db.loadJokers(options.dataDir + "/jokers.json")) {
+        std::cerr << "[Fatal] Failed to load game data from " << options.dataDir << std::endl;
+        return 1;
+    }
+
+    if (!options.replayPath.empty()) return runReplay(db, options);
+    if (options.benchClone) return runCloneBench(db, options);
+    if (options.benchOdds) return runOddsBench(db, options);
+    if (options.benchDiscard) return runDiscardBench(db, options);
+    if (options.benchShuffle) return runShuffleBench(options);
+    if (options.benchEval) return runEvalBench(options);
+    if (options.checkExpr) return runExprCheck(db, options);
+    if (options.checkEval) return runEvalCheck();
+    if (options.checkAlloc) return runAllocCheck(db, options);
+    if (options.checkTrace) return runTraceCheck(db, options);
+
+    long long totalRounds = 0;
+    long long totalSteps = 0;
+    int victories = 0;
+    SolveStats solveStats;
+    SolverConfig solverConfig;
+    solverConfig.threads = options.threads;
+    solverConfig.nodeLimit = options.nodeLimit;
+    solverConfig.timeLimitMs = options.timeLimitMs;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int run = 0; run < options.runs; ++run) {
+        SimConfig config;
+        config.seed = options.seed + static_cast<std::uint64_t>(run);
+        config.maxRounds = options.maxRounds;
+
+        RunSimulator sim(db, config);
+        long long steps = 0;
+        if (options.solve) {
+            steps = playOutSolver(db, sim, solverConfig, solveStats);
+        } else if (options.mctsIterations > 0) {
+            steps = playOutMcts(db, sim, options.mctsIterations);
+        } else {
+            steps = SimPolicy::PlayOutGreedy(sim);
+        }
+        if (steps < 0) {
+            std::cerr << "[Error] Policy produced an illegal action (seed " << config.seed << ")" << std::endl;
+            return 1;
+        }
+        totalSteps += steps;
+
+        totalRounds += sim.roundsCleared();
+        if (sim.context().state == GameState::Victory) ++victories;
+        if (options.verbose) {
+            std::cout << "seed=" << config.seed
+                      << " rounds=" << sim.roundsCleared()
+                      << " money=" << sim.context().money
+                      << " jokers=" << sim.jokers().size()
+                      << (sim.context().state == GameState::Victory ? " WIN" : " LOSS") << '\n';
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "runs=" << options.runs
+              << " victories=" << victories
+              << " avg_rounds=" << static_cast<double>(totalRounds) / options.runs
+              << " steps=" << totalSteps
+              << " runs_per_sec=" << (seconds > 0 ? options.runs / seconds : 0.0)
+              << std::endl;
+    if (options.solve && solveStats.blinds > 0) {
+        std::cout << "solved_blinds=" << solveStats.blinds
+                  << " cleared=" << solveStats.cleared
+                  << " avg_hands=" << (solveStats.cleared > 0 ? static_cast<double>(solveStats.handsUsed) / solveStats.cleared : 0.0)
+                  << " aborted=" << solveStats.aborted
+                  << " avg_nodes=" << static_cast<double>(solveStats.nodes) / solveStats.blinds
+                  << " avg_ms=" << 1000.0 * solveStats.seconds / solveStats.blinds
+                  << std::endl;
+    }
+    return 0;
+}